@@ -1,6 +1,9 @@
 #pragma once
 
 #include <map>
+#include <set>
+#include <bitset>
+#include <cstdint>
 #include <iostream>
 #include <memory>
 #include <utility>
@@ -13,7 +16,48 @@
 #include <iomanip>
 #include <sstream>
 #include <algorithm>
+#include <iterator>
 #include <functional>
+#include <atomic>
+#include <mutex>
+#include <future>
+#include <thread>
+#ifdef __cpp_impl_coroutine
+#include <coroutine>
+#endif
+#include <exception>
+#include <limits>
+#include <string_view>
+#include <charconv>
+#include <deque>
+#ifdef ARGPARSER_INSTRUMENTATION
+#include <chrono>
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+#define ARGPARSER_POSIX_IO
+#include <fcntl.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#endif
+
+// SSE2 is used to scan command line strings, define ARGPARSER_NO_SIMD to disable
+#if !defined(ARGPARSER_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define ARGPARSER_SSE2
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#ifdef ARGPARSER_INSTRUMENTATION
+#define ARGPARSER_PHASE_BEGIN(timer, phase_name, key) \
+    parser_internal::phaseTimer timer(m_observer, parseObserver::phase::phase_name, key, m_conversions)
+#define ARGPARSER_PHASE_END(timer, tokens, conversions) timer.report(tokens, conversions)
+#else
+#define ARGPARSER_PHASE_BEGIN(timer, phase_name, key)
+#define ARGPARSER_PHASE_END(timer, tokens, conversions)
+#endif
 
 namespace parser_internal{
 
@@ -70,15 +114,423 @@ namespace parser_internal{
         return internal::GetTypeNameHelper<T>::GetTypeName();
     }
 
+    /// type name built once per type and shared by all arguments of that type
+    template <typename T>
+    std::string_view InternedTypeName(){
+        static const std::string name = GetTypeName<T>();
+        return name;
+    }
+
+    /// Position of the first of chars C in [p, end), or end. Scans 16 bytes at a time with SSE2
+    template<char... C>
+    inline const char *findAnyOf(const char *p, const char *end){
+#ifdef ARGPARSER_SSE2
+        while(end - p >= 16){
+            const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            __m128i hits = _mm_setzero_si128();
+            ((hits = _mm_or_si128(hits, _mm_cmpeq_epi8(block, _mm_set1_epi8(C)))), ...);
+            if(auto mask = unsigned(_mm_movemask_epi8(hits))){
+#ifdef _MSC_VER
+                unsigned long idx;
+                _BitScanForward(&idx, mask);
+                return p + idx;
+#else
+                return p + __builtin_ctz(mask);
+#endif
+            }
+            p += 16;
+        }
+#endif
+        while(p < end && ((*p != C) && ...)){
+            ++p;
+        }
+        return p;
+    }
+
+    inline bool isShellSpace(char c){
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+    }
+
+    /// Read whole file, works for files with unknown size (e.g. in /proc). If max_size isn't 0, stops once it's exceeded
+    inline bool readFile(const char *path, std::string &out, size_t max_size = 0){
+        out.clear();
+        auto full = [&out, max_size](){
+            return max_size != 0 && out.size() > max_size;
+        };
+#ifdef ARGPARSER_POSIX_IO
+        int fd = ::open(path, O_RDONLY);
+        if(fd < 0){
+            return false;
+        }
+        char buf[4096];
+        ssize_t n = 0;
+        while(!full() && (n = ::read(fd, buf, sizeof(buf))) > 0){
+            out.append(buf, size_t(n));
+        }
+        ::close(fd);
+        return full() || n == 0;
+#else
+        std::ifstream file(path, std::ios::binary);
+        if(!file){
+            return false;
+        }
+        char buf[4096];
+        while(!full() && file.read(buf, sizeof(buf)).gcount() > 0){
+            out.append(buf, size_t(file.gcount()));
+        }
+        return true;
+#endif
+    }
+
+    /// Trie of dotted option paths ("db.primary.host" without leading '-'), one node per segment
+    class segmentTrie{
+    public:
+        /// alias paths are found by find(), but not listed by forEach()
+        void insert(std::string_view path, std::string_view key, bool alias = false){
+            node *n = &m_root;
+            forEachSegment(path, [&n](std::string_view segment){
+                auto it = n->children.find(segment);
+                if(it == n->children.end()){
+                    it = n->children.emplace(std::string(segment), std::make_unique<node>()).first;
+                }
+                n = it->second.get();
+                return true;
+            });
+            n->key = key;
+            n->alias = alias;
+        }
+        /// Key stored for path, empty if none
+        [[nodiscard]] std::string_view find(std::string_view path) const{
+            const node *n = &m_root;
+            forEachSegment(path, [&n](std::string_view segment){
+                auto it = n->children.find(segment);
+                n = it == n->children.end() ? nullptr : it->second.get();
+                return n != nullptr;
+            });
+            return n == nullptr ? std::string_view() : n->key;
+        }
+        /// Call f(path relative to prefix, key) for all keys below prefix. Returns false if there is no such prefix
+        template<typename F>
+        bool forEach(std::string_view prefix, F &&f) const{
+            const node *n = &m_root;
+            if(!prefix.empty()){
+                forEachSegment(prefix, [&n](std::string_view segment){
+                    auto it = n->children.find(segment);
+                    n = it == n->children.end() ? nullptr : it->second.get();
+                    return n != nullptr;
+                });
+            }
+            if(n == nullptr){
+                return false;
+            }
+            std::string path;
+            visit(*n, path, f);
+            return true;
+        }
+    private:
+        struct node{
+            std::map<std::string, std::unique_ptr<node>, std::less<>> children;
+            std::string_view key; // argument with this path, if any
+            bool alias = false;   // path is alias of the key
+        };
+        node m_root;
+
+        template<typename F>
+        static void forEachSegment(std::string_view path, F &&f){
+            size_t start = 0;
+            while(true){
+                auto dot = path.find('.', start);
+                if(!f(path.substr(start, dot - start)) || dot == std::string_view::npos){
+                    return;
+                }
+                start = dot + 1;
+            }
+        }
+
+        template<typename F>
+        static void visit(const node &n, std::string &path, F &f){
+            for(const auto &x : n.children){
+                const auto size = path.size();
+                if(size > 0){
+                    path += '.';
+                }
+                path += x.first;
+                if(!x.second->key.empty() && !x.second->alias){
+                    f(std::string_view(path), x.second->key);
+                }
+                visit(*x.second, path, f);
+                path.resize(size);
+            }
+        }
+    };
+
+    /// Compressed trie of words (keys, aliases, command names) resolving unambiguous prefixes in O(prefix length)
+    class prefixTrie{
+        struct node{
+            std::string label;                          // edge from parent
+            std::vector<std::unique_ptr<node>> children; // first chars of labels differ
+            std::string_view target;                    // if a word ends here
+            std::string_view unique;                    // target of all words below, if there is only one
+            bool ambiguous = false;
+
+            [[nodiscard]] auto child(char c) const{
+                return std::find_if(children.begin(), children.end(), [c](const auto &x){return x->label.front() == c;});
+            }
+            auto child(char c){
+                return std::find_if(children.begin(), children.end(), [c](const auto &x){return x->label.front() == c;});
+            }
+        };
+    public:
+        struct match{
+            std::string_view target; // empty if not found or ambiguous
+            bool ambiguous = false;
+        };
+
+        void clear(){
+            m_root.children.clear();
+        }
+
+        /// Add word which resolves to target (e.g. alias to its key)
+        void insert(std::string_view word, std::string_view target){
+            node *n = &m_root;
+            while(!word.empty()){
+                auto it = n->child(word.front());
+                if(it == n->children.end()){
+                    auto leaf = std::make_unique<node>();
+                    leaf->label = std::string(word);
+                    leaf->target = target;
+                    leaf->unique = target;
+                    n->children.push_back(std::move(leaf));
+                    return;
+                }
+                const auto common = commonPrefix((*it)->label, word);
+                if(common < (*it)->label.size()){
+                    // split edge
+                    auto mid = std::make_unique<node>();
+                    mid->label = (*it)->label.substr(0, common);
+                    mid->unique = (*it)->unique;
+                    mid->ambiguous = (*it)->ambiguous;
+                    (*it)->label.erase(0, common);
+                    mid->children.push_back(std::move(*it));
+                    *it = std::move(mid);
+                }
+                n = it->get();
+                // all words below share one target until another one is added
+                if(!n->ambiguous && n->unique != target){
+                    n->ambiguous = true;
+                    n->unique = {};
+                }
+                word.remove_prefix(common);
+            }
+            n->target = target;
+        }
+
+        /// Exact word wins, otherwise prefix resolves if all words starting with it have the same target
+        [[nodiscard]] match resolve(std::string_view prefix) const{
+            const node *n = &m_root;
+            while(!prefix.empty()){
+                auto it = n->child(prefix.front());
+                if(it == n->children.end()){
+                    return {};
+                }
+                const node *c = it->get();
+                const auto common = commonPrefix(c->label, prefix);
+                if(common == prefix.size()){
+                    if(common == c->label.size() && !c->target.empty()){
+                        return {c->target};
+                    }
+                    return {c->unique, c->ambiguous};
+                }
+                if(common < c->label.size()){
+                    return {};
+                }
+                prefix.remove_prefix(common);
+                n = c;
+            }
+            return {};
+        }
+
+        /// All words starting with prefix, sorted
+        [[nodiscard]] std::vector<std::string> candidates(std::string_view prefix) const{
+            std::vector<std::string> res;
+            const node *n = &m_root;
+            std::string word;
+            while(!prefix.empty()){
+                auto it = n->child(prefix.front());
+                if(it == n->children.end()){
+                    return res;
+                }
+                const auto common = commonPrefix((*it)->label, prefix);
+                if(common < prefix.size() && common < (*it)->label.size()){
+                    return res;
+                }
+                n = it->get();
+                word += n->label;
+                prefix.remove_prefix(common);
+            }
+            collect(*n, word, res);
+            std::sort(res.begin(), res.end());
+            return res;
+        }
+
+    private:
+        node m_root;
+
+        static size_t commonPrefix(std::string_view a, std::string_view b){
+            return size_t(std::mismatch(a.begin(), a.begin() + std::min(a.size(), b.size()), b.begin()).first - a.begin());
+        }
+
+        static void collect(const node &n, std::string &word, std::vector<std::string> &res){
+            if(!n.target.empty()){
+                res.push_back(word);
+            }
+            for(const auto &x : n.children){
+                word += x->label;
+                collect(*x, word, res);
+                word.resize(word.size() - x->label.size());
+            }
+        }
+    };
+
+    /// Growable bitset, one bit per argument id. Whole-set checks work on 64-bit words
+    class dynamicBitset{
+    public:
+        static constexpr size_t npos = size_t(-1);
+
+        void resize(size_t bits){
+            m_words.resize((bits + 63) / 64, 0);
+        }
+        void set(size_t i, bool value = true){
+            if(i / 64 >= m_words.size()){
+                resize(i + 1);
+            }
+            auto mask = uint64_t(1) << (i % 64);
+            m_words[i / 64] = value ? (m_words[i / 64] | mask) : (m_words[i / 64] & ~mask);
+        }
+        [[nodiscard]] bool test(size_t i) const {
+            return i / 64 < m_words.size() && (m_words[i / 64] >> (i % 64)) & 1;
+        }
+        void reset(){
+            std::fill(m_words.begin(), m_words.end(), 0);
+        }
+        [[nodiscard]] bool any() const {
+            return std::any_of(m_words.begin(), m_words.end(), [](uint64_t w){ return w != 0; });
+        }
+        [[nodiscard]] size_t count() const {
+            size_t res = 0;
+            for(auto w : m_words){
+                res += std::bitset<64>(w).count();
+            }
+            return res;
+        }
+        // true if any bit is set in both
+        [[nodiscard]] bool intersects(const dynamicBitset &other) const {
+            auto size = std::min(m_words.size(), other.m_words.size());
+            for(size_t i = 0; i < size; ++i){
+                if(m_words[i] & other.m_words[i]){
+                    return true;
+                }
+            }
+            return false;
+        }
+        // number of bits set in both
+        [[nodiscard]] size_t countCommon(const dynamicBitset &other) const {
+            size_t res = 0;
+            auto size = std::min(m_words.size(), other.m_words.size());
+            for(size_t i = 0; i < size; ++i){
+                res += std::bitset<64>(m_words[i] & other.m_words[i]).count();
+            }
+            return res;
+        }
+        // first bit set here, but not in other (npos if none)
+        [[nodiscard]] size_t firstNotIn(const dynamicBitset &other) const {
+            for(size_t i = 0; i < m_words.size(); ++i){
+                auto w = m_words[i] & ~(i < other.m_words.size() ? other.m_words[i] : 0);
+                if(w){
+                    return i * 64 + lowestBit(w);
+                }
+            }
+            return npos;
+        }
+        // first bit set in both, starting from bit 'from' (npos if none)
+        [[nodiscard]] size_t firstCommon(const dynamicBitset &other, size_t from = 0) const {
+            auto size = std::min(m_words.size(), other.m_words.size());
+            for(size_t i = from / 64; i < size; ++i){
+                auto w = m_words[i] & other.m_words[i];
+                if(i == from / 64){
+                    w &= ~uint64_t(0) << (from % 64);
+                }
+                if(w){
+                    return i * 64 + lowestBit(w);
+                }
+            }
+            return npos;
+        }
+    private:
+        static size_t lowestBit(uint64_t w){
+            size_t bit = 0;
+            while(!((w >> bit) & 1)){
+                ++bit;
+            }
+            return bit;
+        }
+
+        std::vector<uint64_t> m_words;
+    };
+
+    /// Keeps one copy of every distinct string (help texts, metavars), views to them stay valid
+    class stringPool{
+    public:
+        std::string_view intern(std::string_view s){
+            if(s.empty()){
+                return {};
+            }
+            auto it = m_strings.find(s);
+            if(it == m_strings.end()){
+                it = m_strings.emplace(s).first;
+            }
+            return *it;
+        }
+    private:
+        std::set<std::string, std::less<>> m_strings;
+    };
+
+    inline bool equals_ignore_case(const char *a, const char *b) noexcept {
+        while(*a && std::tolower(static_cast<unsigned char>(*a)) == *b){
+            ++a;
+            ++b;
+        }
+        return *a == '\0' && *b == '\0';
+    }
+
     template<typename T>
-    inline T scan_number(const std::string &s){
+    inline T scan_number(std::string_view s){
         T res = 0;
+        const bool hex = s.size() >= 2 && s[0] == '0' && (s[1] == 'x' || s[1] == 'X');
+        // plain decimal or hex numbers are converted in place, anything else goes through a stream
+        const char *first = s.data() + (hex ? 2 : 0);
+        const char *last = s.data() + s.size();
+        if constexpr(std::is_integral_v<T>){
+            auto [ptr, ec] = std::from_chars(first, last, res, hex ? 16 : 10);
+            if(ec == std::errc() && ptr == last){
+                return res;
+            }
+        }
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+        else if(!hex && s.find_first_not_of("0123456789.eE+-") == std::string_view::npos){
+            auto [ptr, ec] = std::from_chars(first, last, res);
+            if(ec == std::errc() && ptr == last){
+                return res;
+            }
+        }
+#endif
+        const std::string str(s);
         // string stream to parse numbers in different notations
-        std::stringstream ss(s);
+        std::stringstream ss(str);
         auto pos = ss.tellg();
         // parse hex (no hexfloat)
-        if(starts_with("0x", s) || starts_with("0X", s)){
-            ss.str(s.substr(2));
+        if(hex){
+            ss.str(str.substr(2));
             pos = ss.tellg();
             ss >> std::hex >> res;
         }else{
@@ -88,44 +540,42 @@ namespace parser_internal{
         auto distance = ss.tellg() - pos;
         bool fail = ss.fail() && !ss.eof();
         if(fail || distance > 0){
-            throw std::runtime_error(std::string(__func__) + ": could not convert " + s + " to " + GetTypeName<T>());
+            throw std::runtime_error(std::string(__func__) + ": could not convert " + str + " to " + GetTypeName<T>());
         }
         return res;
     }
 
     template<class Target, class Source>
-    Target narrow_cast(Source v, const std::string &s = ""){
+    Target narrow_cast(Source v, std::string_view s = ""){
         auto r = static_cast<Target>(v); // convert the value to the target type
         if (static_cast<Source>(r) != v){
-            throw std::runtime_error{std::string(__func__) + ": " + s + " not representable as " + GetTypeName<Target>()};
+            throw std::runtime_error{std::string(__func__) + ": " + std::string(s) + " not representable as " + GetTypeName<Target>()};
         }
         return r;
     }
 
     template<typename T>
     T scan(const char* arg){
-        std::string temp = (arg == nullptr) ? "" : std::string(arg);
+        // no copies of the token, conversions don't allocate unless they fail
+        const std::string_view temp = (arg == nullptr) ? "" : arg;
         T res;
         if constexpr(std::is_convertible_v<T, const char*>){
             return arg;
         }else if constexpr(std::is_same_v<T, std::string>){
-            return temp;
+            return std::string(temp);
         }else if constexpr(std::is_same_v<T, bool>){
-            auto isTrue = [func=__func__](const char *s){
-                for(const auto &i : BOOL_POSITIVES){
-                    if(!strcmp(s, i)) return true;
-                }
-                for(const auto &i : BOOL_NEGATIVES){
-                    if(!strcmp(s, i)) return false;
-                }
-                throw std::runtime_error(std::string(func) + ": unable to convert " + s + " to bool");
-            };
+            for(const auto &i : BOOL_POSITIVES){
+                if(equals_ignore_case(temp.data(), i)) return true;
+            }
+            for(const auto &i : BOOL_NEGATIVES){
+                if(equals_ignore_case(temp.data(), i)) return false;
+            }
             std::string lVal;
             //convert to lower case
             for(auto elem : temp) {
                 lVal += char(std::tolower(elem));
             }
-            return isTrue(lVal.c_str());
+            throw std::runtime_error(std::string(__func__) + ": unable to convert " + lVal + " to bool");
         }/// arithmetic
         else if constexpr(std::is_arithmetic_v<T>){
             /// char special
@@ -149,7 +599,7 @@ namespace parser_internal{
             }
         }/// not convertible
         else{
-            throw std::logic_error(std::string(__func__) + ": no converter for " + temp + " of type " + GetTypeName<T>());
+            throw std::logic_error(std::string(__func__) + ": no converter for " + std::string(temp) + " of type " + GetTypeName<T>());
         }
         return res;
     }
@@ -162,9 +612,66 @@ namespace parser_internal{
                 std::is_arithmetic_v<T>;                      // arithmetic
     };
 
-    inline void validateKeyOrParam(const std::string &key, bool is_param, const char* func){
+    /// std::atomic variable bound to an argument
+    template<typename T>
+    struct atomicBinding{
+        std::atomic<T> *ptr = nullptr;
+        std::memory_order order = std::memory_order_release;
+    };
+
+    /// Receives values of nargs/variadic argument one by one
+    template<typename T>
+    struct valueSink{
+        std::function<void(T&&)> push;
+        std::function<void(size_t)> reserve; // optional, called with number of values before the first push
+        std::function<void()> reset;         // optional, drops values pushed by parser (container of appendTo)
+    };
+
+    template<typename C, typename = void>
+    struct has_reserve : std::false_type {};
+
+    template<typename C>
+    struct has_reserve<C, std::void_t<decltype(std::declval<C&>().reserve(size_t{})),
+                                      decltype(std::declval<C&>().capacity())>> : std::true_type {};
+
+    template<typename C, typename = void>
+    struct has_erase : std::false_type {};
+
+    template<typename C>
+    struct has_erase<C, std::void_t<decltype(std::declval<C&>().erase(std::declval<C&>().begin(), std::declval<C&>().end()))>>
+            : std::true_type {};
+
+    /// Tokens split off the one being preprocessed (LIFO, no allocations)
+    class pendingTokens{
+    public:
+        void push(std::string &&token){
+            if(m_size == m_tokens.size()){
+                throw std::logic_error("too many pending tokens");
+            }
+            m_tokens[m_size++] = std::move(token);
+        }
+        std::string pop(){
+            return std::move(m_tokens[--m_size]);
+        }
+        [[nodiscard]] bool empty() const{
+            return m_size == 0;
+        }
+    private:
+        std::array<std::string, 2> m_tokens;
+        size_t m_size = 0;
+    };
+
+    template<typename T, typename = void>
+    struct is_equality_comparable : std::false_type {};
+
+    template<typename T>
+    struct is_equality_comparable<T, std::void_t<decltype(std::declval<const T&>() == std::declval<const T&>())>>
+            : std::true_type {};
+
+    /// namespaced - option key or alias, '.' is allowed there as namespace separator
+    inline void validateKeyOrParam(const std::string &key, bool is_param, const char* func, bool namespaced = false){
         auto isValidKeyChar = [](int c) -> bool {
-            return std::isalnum(c) || c == '-' || c == '_';
+            return std::isalnum(c) || c == '-' || c == '_' || c == '.';
         };
         auto isValidParamChar = [](int c) -> bool {
             return std::isalnum(c) || std::ispunct(c) || std::isspace(c);
@@ -178,15 +685,87 @@ namespace parser_internal{
         auto allDigitsAndPunct = std::all_of(key.begin(), key.end(), isDigitOrPunct);
         if(key.empty())
             throw std::invalid_argument(std::string(func) + ": empty key or param");
+        if(invalidChar == key.end() && !is_param && !namespaced)
+            invalidChar = std::find(key.begin(), key.end(), '.');
         if(invalidChar != key.end())
             throw std::invalid_argument(std::string(func) + ": " + key + " cannot contain " + *invalidChar);
         if(allDigitsAndPunct)
             throw std::invalid_argument(std::string(func) + ": " + key + " cannot consist only of digits and punctuation chars");
         if(key.back() == '-')
             throw std::invalid_argument(std::string(func) + ": " + key + " shouldn't end with '-'");
+        // '.' separates namespace segments
+        if(namespaced && key.find('.') != std::string::npos){
+            const auto path = std::string_view(key).substr(key.find_first_not_of('-'));
+            if(path.front() == '.' || path.back() == '.' || path.find("..") != std::string_view::npos)
+                throw std::invalid_argument(std::string(func) + ": " + key + " cannot contain empty namespace segment");
+        }
     }
 }
 
+#ifdef ARGPARSER_INSTRUMENTATION
+/// Receives durations and counters of parse phases. Available if ARGPARSER_INSTRUMENTATION is defined
+class parseObserver{
+public:
+    enum class phase{
+        PREPROCESS, // handling '=', aliases, combined args
+        ARGUMENT,   // conversion and callable of a single argument
+        TYPOS,      // typo detection for unknown token
+        CALLBACK,   // parser callback
+        PARSE       // whole parse, including all the above
+    };
+    struct counters{
+        size_t tokens = 0;          // tokens seen (after preprocessing)
+        size_t conversions = 0;     // argument actions run
+        size_t allocations = 0;     // as reported by allocationCount()
+        size_t allocated_bytes = 0; // as reported by allocatedBytes()
+    };
+    virtual ~parseObserver() = default;
+    /// Called when a phase completes. key - argument name for ARGUMENT, parser name otherwise. Must not throw
+    virtual void onPhase(phase p, const std::string &key, std::chrono::nanoseconds elapsed, const counters &delta) {}
+    /// Override to report totals of a counting allocator
+    [[nodiscard]] virtual size_t allocationCount() const {return 0;}
+    [[nodiscard]] virtual size_t allocatedBytes() const {return 0;}
+};
+
+namespace parser_internal{
+    class phaseTimer{
+    public:
+        phaseTimer(parseObserver *observer, parseObserver::phase p, const std::string &key, size_t &conversions)
+                : m_observer(observer), m_phase(p), m_key(key), m_conversions(conversions), m_conversions_start(conversions) {
+            if(m_observer != nullptr){
+                m_allocations = m_observer->allocationCount();
+                m_bytes = m_observer->allocatedBytes();
+                m_start = std::chrono::steady_clock::now();
+            }
+        }
+        void report(size_t tokens, size_t conversions) {
+            if(m_phase == parseObserver::phase::ARGUMENT){
+                m_conversions += conversions;
+            }
+            if(m_observer == nullptr){
+                return;
+            }
+            auto elapsed = std::chrono::steady_clock::now() - m_start;
+            parseObserver::counters delta;
+            delta.tokens = tokens;
+            delta.conversions = m_phase == parseObserver::phase::PARSE ? m_conversions - m_conversions_start : conversions;
+            delta.allocations = m_observer->allocationCount() - m_allocations;
+            delta.allocated_bytes = m_observer->allocatedBytes() - m_bytes;
+            m_observer->onPhase(m_phase, m_key, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed), delta);
+        }
+    private:
+        parseObserver *m_observer;
+        parseObserver::phase m_phase;
+        const std::string &m_key;
+        size_t &m_conversions;
+        size_t m_conversions_start;
+        size_t m_allocations = 0;
+        size_t m_bytes = 0;
+        std::chrono::steady_clock::time_point m_start;
+    };
+}
+#endif
+
 class ArgHandleBase{
 protected:
     friend class argParser;
@@ -204,7 +783,25 @@ protected:
     virtual bool is_variadic() {return false;}
     virtual void set_nargs(unsigned int n) {}
     virtual unsigned int get_nargs() {return 0;}
-    virtual std::any get_any_val() const {return {};}
+    virtual const std::any &get_any_val() const {
+        static const std::any empty;
+        return empty;
+    }
+    virtual void save_initial() {}
+    virtual void reset() {}
+    virtual void restore(const std::any &val) {}
+    virtual bool same_value(const std::any &val) const {return false;}
+    virtual void hold_global(bool hold) {}
+    virtual void publish_global() {}
+    virtual bool has_plain_global() const {return false;} // plain global pointer or container of appendTo
+    virtual bool has_sink() const {return false;}
+    // default provider which hasn't run yet, as a function published values can run on first read
+    virtual std::function<std::any()> pending_default() const {return {};}
+    // error_wrapper makes exception thrown by deferred action look like a parse error (key and tokens)
+    using error_wrapper = std::function<std::exception_ptr(const char *what, const std::string *args, int size)>;
+    virtual void make_lazy(error_wrapper &&wrap_error) {}
+    virtual void set_sink(std::any &&sink) {}
+    virtual void set_default_provider(std::any &&provider) {}
 
 public:
     virtual ~ArgHandleBase() = default;
@@ -221,10 +818,35 @@ private:
     std::any m_anyval;
     std::tuple<Targs...> m_action_and_args; //holds action (function, lambda, etc) and side args supplied to it
     T *m_global = nullptr;
+    parser_internal::atomicBinding<T> m_global_atomic;
+    bool m_hold_global = false;
+    std::any m_initial;
     NContainer m_choices {};
     bool m_variadic = false;
     unsigned int m_nargs = 0;
     bool m_single_narg = false;
+    // lazy action: tokens are kept (owned by parser) until the value is read for the first time
+    struct lazyCall{
+        lazyCall(const std::string *args, int size) : args(args), size(size) {}
+        const std::string *args;
+        int size;
+        std::once_flag once;
+        std::exception_ptr error;
+    };
+    bool m_lazy = false;
+    mutable std::unique_ptr<lazyCall> m_lazy_call;
+    error_wrapper m_lazy_error;
+    // variadic values are passed here one by one instead of being stored
+    std::unique_ptr<parser_internal::valueSink<T>> m_sink;
+    // default computed on first read if argument is not set, kept for following runs
+    struct defaultProvider{
+        std::function<T()> func;
+        std::mutex mutex;
+        std::atomic<bool> pending {true};
+        bool evaluated = false;
+        T value {};
+    };
+    std::unique_ptr<defaultProvider> m_default_provider;
 
     [[nodiscard]] static constexpr bool has_action() {
         // if tuple is not empty, it has function
@@ -260,11 +882,69 @@ private:
 
     void set_any_val() {
         set_global();
-        m_anyval = m_value;
+        // reuse storage if possible
+        if(auto v = std::any_cast<T>(&m_anyval)){
+            *v = m_value;
+        }else{
+            m_anyval = m_value;
+        }
     }
 
-    // parse variadic params, single scan and common action
     void action(const std::string *args, int size) override {
+        if(m_default_provider){
+            m_default_provider->pending.store(false, std::memory_order_relaxed);
+        }
+        if(m_lazy){
+            m_lazy_call.reset(new lazyCall{args, size});
+            return;
+        }
+        run_action(args, size);
+    }
+
+    // run deferred action once, any thread may be the first reader
+    void run_lazy() const {
+        if(auto call = m_lazy_call.get()){
+            std::call_once(call->once, [this, call]{
+                try{
+                    const_cast<ArgHandle*>(this)->run_action(call->args, call->size);
+                }catch(std::exception &e){
+                    call->error = m_lazy_error(e.what(), call->args, call->size);
+                }catch(...){
+                    call->error = m_lazy_error("unknown error", call->args, call->size);
+                }
+            });
+            if(call->error){
+                std::rethrow_exception(call->error);
+            }
+        }
+    }
+
+    // provider runs once, its value is reused by reload and published values. Called under provider's mutex
+    static const T &evaluate(defaultProvider &provider) {
+        if(!provider.evaluated){
+            provider.value = provider.func();
+            provider.evaluated = true;
+        }
+        return provider.value;
+    }
+
+    // any thread may be the first reader
+    void run_default_provider() const {
+        auto provider = m_default_provider.get();
+        if(!provider || !provider->pending.load(std::memory_order_acquire)){
+            return;
+        }
+        std::lock_guard<std::mutex> lock(provider->mutex);
+        if(provider->pending.load(std::memory_order_relaxed)){
+            auto self = const_cast<ArgHandle*>(this);
+            self->m_value = evaluate(*provider);
+            self->set_any_val();
+            provider->pending.store(false, std::memory_order_release);
+        }
+    }
+
+    // parse variadic params, single scan and common action
+    void run_action(const std::string *args, int size) {
         if(!m_variadic && m_nargs == 0) {
             // if implicit
             bool implicit = STR_ARGS == 0 && !m_single_narg;
@@ -289,17 +969,35 @@ private:
     void parse_variadic(const std::string *args, int size) {
         // parse variadic
         NContainer res;
+        if(!m_sink){
+            res.reserve(size);
+        }else if(m_sink->reserve){
+            m_sink->reserve(size);
+        }
         // variadic action
         for(int i=0; i<size; ++i){
-            if constexpr(has_action()){
-                parse_common(&args[i], 1);
-            }else{
-                m_value = parser_internal::scan<T>(args[i].c_str());
+            try{
+                if constexpr(has_action()){
+                    parse_common(&args[i], 1);
+                }else{
+                    m_value = parser_internal::scan<T>(args[i].c_str());
+                }
+                check_choices();
+                if(m_sink){
+                    m_sink->push(std::move(m_value));
+                }else{
+                    res.push_back(m_value);
+                }
+            }catch(std::exception &e){
+                throw std::runtime_error("element " + std::to_string(i) + ": " + e.what());
             }
-            check_choices();
-            res.push_back(m_value);
         }
-        containerize(std::move(res));
+        // reuse storage if possible
+        if(auto v = std::any_cast<NContainer>(&m_anyval)){
+            *v = std::move(res);
+        }else{
+            containerize(std::move(res));
+        }
     }
     // for implicit args only
     void parse_implicit(){
@@ -395,13 +1093,52 @@ private:
     }
 
     void set_global_ptr(const std::any &ptr) override {
-        m_global = std::any_cast<T*>(ptr);
+        if(auto atomic = std::any_cast<parser_internal::atomicBinding<T>>(&ptr)){
+            m_global_atomic = *atomic;
+        }else{
+            m_global = std::any_cast<T*>(ptr);
+        }
     }
 
     void set_global() {
+        if(!m_hold_global) {
+            publish_global();
+        }
+    }
+
+    // hold global writes back (while reloading)
+    void hold_global(bool hold) override {
+        m_hold_global = hold;
+    }
+
+    [[nodiscard]] bool has_plain_global() const override {
+        return m_global != nullptr || (m_sink && m_sink->reset);
+    }
+
+    [[nodiscard]] bool has_sink() const override {
+        return m_sink != nullptr;
+    }
+
+    [[nodiscard]] std::function<std::any()> pending_default() const override {
+        auto provider = m_default_provider.get();
+        if(!provider || !provider->pending.load(std::memory_order_acquire)){
+            return {};
+        }
+        return [provider]{
+            std::lock_guard<std::mutex> lock(provider->mutex);
+            return std::any(evaluate(*provider));
+        };
+    }
+
+    void publish_global() override {
         if(m_global != nullptr) {
             *m_global = m_value;
         }
+        if constexpr(std::is_arithmetic_v<T>) {
+            if(m_global_atomic.ptr != nullptr) {
+                m_global_atomic.ptr->store(m_value, m_global_atomic.order);
+            }
+        }
     }
 
     void set_choices(std::vector<std::any> &&choices_list) override {
@@ -428,10 +1165,77 @@ private:
 
     unsigned int get_nargs() override {return m_nargs;}
 
-    std::any get_any_val() const override {
+    const std::any &get_any_val() const override {
+        run_lazy();
+        run_default_provider();
         return m_anyval;
     }
 
+    void make_lazy(error_wrapper &&wrap_error) override {
+        m_lazy = true;
+        m_lazy_error = std::move(wrap_error);
+    }
+
+    void set_default_provider(std::any &&provider) override {
+        m_default_provider = std::make_unique<defaultProvider>();
+        m_default_provider->func = std::any_cast<std::function<T()>>(std::move(provider));
+    }
+
+    void set_sink(std::any &&sink) override {
+        m_sink = std::make_unique<parser_internal::valueSink<T>>(std::any_cast<parser_internal::valueSink<T>>(std::move(sink)));
+    }
+
+    // remember value set upon declaration (default or empty container)
+    void save_initial() override {
+        m_initial = m_anyval;
+    }
+
+    void reset() override {
+        if(m_sink && m_sink->reset){
+            m_sink->reset();
+        }
+        restore(m_initial);
+        if(m_default_provider){
+            m_default_provider->pending.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    void restore(const std::any &val) override {
+        m_lazy_call.reset();
+        if(m_default_provider){
+            m_default_provider->pending.store(false, std::memory_order_relaxed);
+        }
+        m_anyval = val;
+        if(auto v = std::any_cast<T>(&val)){
+            m_value = *v;
+        }
+    }
+
+    [[nodiscard]] bool same_value(const std::any &val) const override {
+        if constexpr(parser_internal::is_equality_comparable<T>::value) {
+            auto equal = [](const T &a, const T &b) {
+                if constexpr(std::is_pointer_v<T> && std::is_convertible_v<T, const char*>) {
+                    // compare strings, not pointers
+                    return (a == nullptr || b == nullptr) ? a == b : !strcmp(a, b);
+                } else {
+                    return a == b;
+                }
+            };
+            const auto &anyval = get_any_val();
+            if(anyval.type() != val.type()){
+                return false;
+            }
+            if(auto v = std::any_cast<T>(&val)){
+                return equal(*v, std::any_cast<const T&>(anyval));
+            }
+            if(auto c = std::any_cast<NContainer>(&val)){
+                const auto &cur = std::any_cast<const NContainer&>(anyval);
+                return std::equal(c->begin(), c->end(), cur.begin(), cur.end(), equal);
+            }
+        }
+        return false;
+    }
+
     explicit ArgHandle(std::tuple<Targs...> &&tpl) :
             m_value(),
             m_anyval(m_value),
@@ -481,42 +1285,58 @@ struct Argument{
 private:
 
     explicit Argument(std::string name) noexcept
-            : m_name(std::move(name)){}
+            : m_name(std::move(name)),
+              m_hidden(false), m_set(false), m_positional(false), m_optional(false),
+              m_required(false), m_implicit(false), m_repeatable(false), m_starts_with_minus(false),
+              m_show_default(false), m_immutable(false), m_lazy(false), m_parallel(false){}
 
     friend class argParser;
     friend class ArgBuilderBase;
     std::string m_name;
-    std::string m_help;
-    std::string m_advanced_help;
-    std::string m_nargs_var;
-    //hidden option
-    bool m_hidden = false;
-    //list of options
-    std::vector<std::string> m_options;
+    //texts are interned in parser's string pool
+    std::string_view m_help;
+    std::string_view m_advanced_help;
+    std::string_view m_nargs_var;
     //stringified type
-    std::string m_type_str;
+    std::string_view m_type_str;
+    //shown in help instead of default computed by provider
+    std::string_view m_default_placeholder;
+    //list of options (empty for nargs)
+    std::vector<std::string> m_options;
+    //number of options (size of nargs range)
+    size_t m_options_count = 0;
     //Option/flag
     std::unique_ptr<ArgHandleBase> m_arg_handle;
-    //in use
-    bool m_set = false;
     //alias
     std::vector<std::string> m_aliases;
-    //Positional
-    bool m_positional = false;
-    //Flag
-    bool m_optional = false;
-    //Required != !optional. if !optional, user should specify all of them. If required, at least one is enough
-    bool m_required = false;
+    //Mandatory opts
+    int m_mandatory_options = 0;
+    //index in parser's bitsets
+    size_t m_id = 0;
+    //hidden option
+    bool m_hidden : 1;
+    //in use
+    bool m_set : 1;
+    //Positional
+    bool m_positional : 1;
+    //Flag
+    bool m_optional : 1;
+    //Required != !optional. if !optional, user should specify all of them. If required, at least one is enough
+    bool m_required : 1;
     //Implicit
-    bool m_implicit = false;
+    bool m_implicit : 1;
     //repeatable
-    bool m_repeatable = false;
+    bool m_repeatable : 1;
     //If starts with minus
-    bool m_starts_with_minus = false;
-    //Mandatory opts
-    int m_mandatory_options = 0;
+    bool m_starts_with_minus : 1;
     //show default
-    bool m_show_default = false;
+    bool m_show_default : 1;
+    //cannot be changed by reload
+    bool m_immutable : 1;
+    //callable runs on first read
+    bool m_lazy : 1;
+    //callable can run concurrently with other arguments
+    bool m_parallel : 1;
 };
 
 // forward-declare for arg builder
@@ -529,15 +1349,20 @@ private:
     std::any m_default_val;
     std::any m_global_ptr;
     std::vector<std::any> m_choices;
+    std::any m_sink;
+    std::any m_default_provider;
 protected:
     std::function<void(std::unique_ptr<Argument> &&)> m_callback;
     std::unique_ptr<Argument> m_arg;
+    parser_internal::stringPool *m_strings;
 
     ArgBuilderBase(const std::string &key,
                    std::vector<std::string> &&aliases,
                    bool is_positional,
-                   std::function<void(std::unique_ptr<Argument> &&)> &&callback)
-                        : m_callback(std::move(callback)) {
+                   std::function<void(std::unique_ptr<Argument> &&)> &&callback,
+                   parser_internal::stringPool *strings)
+                        : m_callback(std::move(callback)),
+                          m_strings(strings) {
         m_arg.reset(new Argument(key));
         m_arg->m_positional = is_positional;
         m_arg->m_aliases = std::move(aliases);
@@ -546,22 +1371,29 @@ protected:
     }
 
     void setArgOpts(std::vector<std::string> &&opts, int mandatory_opts){
+        m_arg->m_options_count = opts.size();
         m_arg->m_options = std::move(opts);
         m_arg->m_mandatory_options = mandatory_opts;
     }
-    void setArgStrType(const std::string &strType){
+    // nargs range is kept as numbers, no strings per option
+    void setArgOptsRange(int mandatory_opts, size_t total_opts){
+        m_arg->m_options.clear();
+        m_arg->m_options_count = total_opts;
+        m_arg->m_mandatory_options = mandatory_opts;
+    }
+    void setArgStrType(std::string_view strType){
         m_arg->m_type_str = strType;
     }
     void setArgNargTraits(const std::string &narg_name, int nargs_size, bool is_variadic){
-        m_arg->m_nargs_var = narg_name;
+        m_arg->m_nargs_var = m_strings->intern(narg_name);
         m_nargs_size = nargs_size;
         m_is_variadic = is_variadic;
     }
     void setArgHelp(const std::string &help){
-        m_arg->m_help = help;
+        m_arg->m_help = m_strings->intern(help);
     }
     void setArgAdvancedHelp(const std::string &adv_help){
-        m_arg->m_advanced_help = adv_help;
+        m_arg->m_advanced_help = m_strings->intern(adv_help);
     }
     void makeArgHidden(){
         if(!m_arg->m_positional && m_arg->m_optional)
@@ -577,6 +1409,12 @@ protected:
             m_arg->m_show_default = !hide_in_help;
         }
     }
+    void setArgDefaultProvider(std::any &&provider, const std::string &placeholder){
+        if(m_arg->m_optional && !m_arg->m_positional && !m_is_variadic) {
+            m_default_provider = std::move(provider);
+            m_arg->m_default_placeholder = m_strings->intern(placeholder);
+        }
+    }
     void setArgGlobPtr(std::any &&ptr){
         m_global_ptr = std::move(ptr);
     }
@@ -590,17 +1428,42 @@ protected:
             m_arg->m_optional = true;
         }
     }
+    void makeArgImmutable(){
+        m_arg->m_immutable = true;
+    }
+    void makeArgLazy(){
+        m_arg->m_lazy = true;
+    }
+    void makeArgParallel(){
+        m_arg->m_parallel = true;
+    }
     void setArgChoices(std::vector<std::any> &&choices){
         m_choices = std::move(choices);
     }
+    void setArgSink(std::any &&sink){
+        m_sink = std::move(sink);
+    }
 
     void createArg(ArgHandleBase *handle) {
-
-        bool is_implicit = m_arg->m_options.empty();
+        // owned before any check, so rejected spec doesn't leak it
+        std::unique_ptr<ArgHandleBase> owned(handle);
+        bool is_implicit = m_arg->m_options_count == 0;
 
         if(!m_arg->m_mandatory_options && !m_arg->m_positional && !m_arg->m_optional){
             throw std::invalid_argument(std::string(__func__) + ": " + m_arg->m_name + " should have at least 1 mandatory parameter");
         }
+        if(m_arg->m_lazy && (m_arg->m_repeatable || m_global_ptr.has_value())){
+            throw std::logic_error(std::string(__func__) + ": " + m_arg->m_name + " lazy argument cannot be repeatable or have global pointer");
+        }
+        if(m_arg->m_parallel && m_arg->m_repeatable){
+            throw std::logic_error(std::string(__func__) + ": " + m_arg->m_name + " parallel argument cannot be repeatable");
+        }
+        if(m_default_provider.has_value() && (m_default_val.has_value() || m_global_ptr.has_value())){
+            throw std::logic_error(std::string(__func__) + ": " + m_arg->m_name + " default provider cannot be used with default value or global pointer");
+        }
+        if(m_sink.has_value() && ((!m_is_variadic && m_nargs_size < 2) || m_arg->m_lazy)){
+            throw std::logic_error(std::string(__func__) + ": " + m_arg->m_name + " sink is applicable only to non-lazy nargs or variadic arguments");
+        }
 
         if (m_is_variadic)
             handle->make_variadic();
@@ -611,7 +1474,12 @@ protected:
         if (!m_choices.empty())
             handle->set_choices(std::move(m_choices));
         handle->set_nargs(m_nargs_size);
-        m_arg->m_arg_handle = std::unique_ptr<ArgHandleBase>(handle);
+        handle->save_initial();
+        if (m_sink.has_value())
+            handle->set_sink(std::move(m_sink));
+        if (m_default_provider.has_value())
+            handle->set_default_provider(std::move(m_default_provider));
+        m_arg->m_arg_handle = std::move(owned);
         m_arg->m_implicit = is_implicit;
 
         m_callback(std::move(m_arg));
@@ -649,8 +1517,9 @@ public:
     explicit ArgBuilder(std::string &&key,
                         std::vector<std::string> &&aliases,
                         std::function<void(std::unique_ptr<Argument> &&)> &&callback,
+                        parser_internal::stringPool *strings,
                         std::tuple<Types...> &&comps)
-            : ArgBuilderBase(std::move(key), std::move(aliases), POSITIONAL, std::move(callback)),
+            : ArgBuilderBase(std::move(key), std::move(aliases), POSITIONAL, std::move(callback), strings),
               m_components(std::move(comps)){}
     // 'move' ctor
     explicit ArgBuilder(ArgBuilderBase *prev, std::tuple<Types...> &&comps)
@@ -705,11 +1574,7 @@ public:
         auto prepareNargs = [this](const std::string &narg_name){
             const bool is_variadic = TO < 0;
             int max_size = TO > int(FRO) ? TO : int(FRO);
-            auto opts = std::vector<std::string>(max_size, narg_name);
-            for(int i = int(FRO); i < TO; ++i) {
-                opts[i] = "[" + opts[i] + "]";
-            }
-            setArgOpts(std::move(opts), FRO);
+            setArgOptsRange(FRO, max_size);
             setArgNargTraits(narg_name, max_size, is_variadic);
         };
 
@@ -786,6 +1651,16 @@ public:
         return (*this);
     }
 
+    // default computed by callable when argument is read, only if it was not set. Result is kept for following runs
+    template<typename Provider>
+    decltype(auto) defaultProvider(Provider &&provider, const std::string &placeholder = "") {
+        auto val = std::get<0>(m_components);
+        using VType = decltype(val);
+        static_assert(std::is_invocable_r_v<VType, Provider&>, "Default provider should return the type of the argument");
+        setArgDefaultProvider(std::function<VType()>(std::forward<Provider>(provider)), placeholder);
+        return (*this);
+    }
+
     template<typename T>
     decltype(auto) globalPtr(T *glob_ptr) {
         auto val = std::get<0>(m_components);
@@ -795,6 +1670,19 @@ public:
         return (*this);
     }
 
+    template<typename T>
+    decltype(auto) globalPtr(std::atomic<T> *glob_ptr, std::memory_order order = std::memory_order_release) {
+        auto val = std::get<0>(m_components);
+        using VType = decltype(val);
+        static_assert(std::is_same_v<VType, T>, "Pointer type mismatch");
+        static_assert(std::is_arithmetic_v<T>, "Atomic pointers are applicable only to arithmetic types");
+        if(order != std::memory_order_relaxed && order != std::memory_order_release && order != std::memory_order_seq_cst){
+            throw std::invalid_argument(std::string(__func__) + ": " + m_arg->getName() + " invalid memory order for store");
+        }
+        setArgGlobPtr(parser_internal::atomicBinding<T>{glob_ptr, order});
+        return (*this);
+    }
+
     decltype(auto) mandatory() {
         makeArgMandatory();
         return (*this);
@@ -805,6 +1693,74 @@ public:
         return (*this);
     }
 
+    decltype(auto) immutable() {
+        makeArgImmutable();
+        return (*this);
+    }
+
+    // callable is safe to run concurrently with callables of other arguments
+    decltype(auto) parallel() {
+        static_assert(CALLABLE_IDX > 0, "Callable should be set before parallel");
+        makeArgParallel();
+        return (*this);
+    }
+
+    // run callable on first read instead of while parsing
+    decltype(auto) lazy() {
+        static_assert(CALLABLE_IDX > 0, "Callable should be set before lazy");
+        makeArgLazy();
+        return (*this);
+    }
+
+    // pass each value of nargs/variadic argument to a callable or an output iterator instead of storing them
+    template<typename Sink>
+    decltype(auto) sink(Sink sink) {
+        auto val = std::get<0>(m_components);
+        using VType = decltype(val);
+        if constexpr(std::is_invocable_v<Sink&, VType&&>) {
+            setArgSink(parser_internal::valueSink<VType>{std::move(sink), {}, {}});
+        } else {
+            static_assert(std::is_assignable_v<decltype(*std::declval<Sink&>()), VType&&>,
+                          "Sink should be a callable or an output iterator accepting the type of the argument");
+            setArgSink(parser_internal::valueSink<VType>{[it = std::move(sink)](VType &&v) mutable {
+                *it = std::move(v);
+                ++it;
+            }, {}, {}});
+        }
+        return (*this);
+    }
+
+    // append values of nargs/variadic argument to user's container (reserved for all of them beforehand)
+    template<typename Container>
+    decltype(auto) appendTo(Container *container) {
+        auto val = std::get<0>(m_components);
+        using VType = decltype(val);
+        static_assert(std::is_same_v<typename Container::value_type, VType>, "Container value type mismatch");
+        if(!container){
+            throw std::invalid_argument(std::string(__func__) + ": " + m_arg->getName() + " container cannot be null");
+        }
+        parser_internal::valueSink<VType> sink{[container](VType &&v){ container->emplace_back(std::move(v)); }, {}, {}};
+        if constexpr(parser_internal::has_reserve<Container>::value) {
+            // grow geometrically, so repeated occurrences don't reallocate each time
+            sink.reserve = [container](size_t n){
+                const auto size = container->size() + n;
+                if(size > container->capacity()){
+                    container->reserve(std::max(size, 2 * container->capacity()));
+                }
+            };
+        }
+        // parsing again (resetParse, bootstrap) starts from the contents it had when it was bound
+        sink.reset = [container, initial = container->size()](){
+            if constexpr(parser_internal::has_erase<Container>::value) {
+                if(container->size() > initial){
+                    container->erase(std::next(container->begin(), std::ptrdiff_t(initial)), container->end());
+                }
+            }
+        };
+        setArgSink(std::move(sink));
+        return (*this);
+    }
+
     template<typename... Choices>
     decltype(auto) choices(Choices ...choices){
         auto val = std::get<0>(m_components);
@@ -836,7 +1792,7 @@ public:
         const bool has_params = STR_PARAM_IDX > 0;
         const bool has_callable = CALLABLE_IDX > 0;
         /// get template type string
-        const auto str_type = parser_internal::GetTypeName<VType>();
+        const auto str_type = parser_internal::InternedTypeName<VType>();
         ///check if default parser for this type is present
         const bool has_default_parser = parser_internal::hasScanHandler<VType>::value;
 
@@ -880,12 +1836,15 @@ class argParser
 {
 public:
     explicit argParser(const std::string &name = "", const std::string &descr = ""){
-        m_argMap[help_key] = std::unique_ptr<Argument>(new Argument(help_key));
-        m_argMap[help_key]->m_help = "Show this message and exit. 'arg' to get help about certain argument";
-        m_argMap[help_key]->m_options = {"[arg]"};
-        m_argMap[help_key]->m_optional = true;
-        m_argMap[help_key]->m_arg_handle = std::unique_ptr<ArgHandleBase>(new ArgHandleBase());
-        m_argMap[help_key]->m_aliases = {help_alias};
+        auto help = std::unique_ptr<Argument>(new Argument(help_key));
+        help->m_help = "Show this message and exit. 'arg' to get help about certain argument";
+        help->m_options = {"[arg]"};
+        help->m_options_count = 1;
+        help->m_optional = true;
+        help->m_arg_handle = std::unique_ptr<ArgHandleBase>(new ArgHandleBase());
+        help->m_aliases = {help_alias};
+        registerArgument(help_key, std::move(help));
+        m_aliasMap[help_alias] = help_key;
 
         m_binary_name = name;
         m_description = descr;
@@ -893,6 +1852,7 @@ public:
         m_callback = []{}; // default callback
     }
     ~argParser(){
+        joinWorker();
         m_argMap.clear();
     }
 
@@ -912,7 +1872,7 @@ public:
                 throw std::invalid_argument("Key cannot be null!");
             }
             auto skey = std::string(k);
-            parser_internal::validateKeyOrParam(skey, /*is_param=*/false, func);
+            parser_internal::validateKeyOrParam(skey, /*is_param=*/false, func, /*namespaced=*/true);
             checkDuplicates(skey, func);
             return skey;
         };
@@ -920,6 +1880,7 @@ public:
         auto aliases = std::vector<std::string>{checkKeys(keys)...};
         auto key = std::move(aliases.back());
         aliases.pop_back();
+        checkNamespaceDuplicates(key, aliases, __func__);
 
         bool flag = key.front() == '-';
 
@@ -931,13 +1892,18 @@ public:
         }
 
         auto callback = [this,m_key=key](std::unique_ptr<Argument> &&arg) {
-            m_argMap[m_key] = std::move(arg);
+            const auto &stored = *arg;
+            registerArgument(m_key, std::move(arg));
+            for(const auto &alias : stored.m_aliases){
+                m_aliasMap[alias] = m_key;
+            }
         };
 
         return ArgBuilder<0,0,false,T>(
                 std::move(key),
                 std::move(aliases),
                 std::forward<decltype(callback)>(callback),
+                &m_strings,
                 std::make_tuple(T{})
         );
     }
@@ -951,10 +1917,8 @@ public:
             if(x->isVariadic()){
                 throw std::invalid_argument(std::string(__func__) + ": " + key + " cannot add positional argument after variadic positional argument " + p);
             }
-            for(const auto &o : x->m_options){
-                if(!parser_internal::isOptMandatory(o)){
-                    throw std::invalid_argument(std::string(__func__) + ": " + key + " cannot add positional argument after positional argument with optional nargs " + p);
-                }
+            if(size_t(x->m_mandatory_options) < x->m_options_count){
+                throw std::invalid_argument(std::string(__func__) + ": " + key + " cannot add positional argument after positional argument with optional nargs " + p);
             }
         }
 
@@ -965,7 +1929,7 @@ public:
         }
 
         auto callback = [this,m_key=key](std::unique_ptr<Argument> &&arg) {
-            m_argMap[m_key] = std::move(arg);
+            registerArgument(m_key, std::move(arg));
             m_posMap.push_back(m_key);
         };
 
@@ -973,10 +1937,19 @@ public:
                 std::move(key),
                 std::vector<std::string>(),
                 std::forward<decltype(callback)>(callback),
+                &m_strings,
                 std::make_tuple(T{})
         ).parameters(ckey); // set single parameter for positional (for size)
     }
 
+#ifdef ARGPARSER_INSTRUMENTATION
+    /// Report parse timings to observer (also used by commands unless they have their own)
+    argParser &setObserver(parseObserver *observer){
+        m_observer = observer;
+        return *this;
+    }
+#endif
+
     template <typename C>
     argParser &setCallback(C &&callback){
         static_assert(std::is_invocable_r_v<void, C>, "Callback must be void()");
@@ -990,13 +1963,14 @@ public:
 
     template <typename T>
     T getValue(const std::string &key){
-        parsedCheck(__func__);
-        auto strType = parser_internal::GetTypeName<T>();
+        if(!m_bootstrapped){
+            parsedCheck(__func__);
+        }
         auto &r = getArg(key);
         try{
             return std::any_cast<T>(r.m_arg_handle->get_any_val());
         }catch(const std::bad_any_cast& e){
-            throw std::invalid_argument(std::string(__func__) + ": " + key + " cannot cast to " + strType);
+            throw std::invalid_argument(std::string(__func__) + ": " + key + " cannot cast to " + parser_internal::GetTypeName<T>());
         }
     }
 
@@ -1027,35 +2001,396 @@ public:
             throw std::invalid_argument(std::string(__func__) + ": " + name + " child command cannot be optional");
         }
         m_commandMap[name] = std::make_unique<argParser>(name, descr);
+        m_long_keys[false].set(static_cast<unsigned char>(name.front()));
         return *m_commandMap.at(name);
     }
 
     /// Parse arguments
     int parseArgs(int argc, char *argv[])
     {
-        if(m_args_parsed){
-            throw parse_error("Repeated attempt to run " + std::string(__func__));
+        prepareParse(argc, argv, __func__);
+        return parseAndReport({argv + 1, argv + argc});
+    }
+
+    /**
+     * Early pass over argv which parses only options added so far and skips all other tokens, e.g.
+     * to get config file or plugins dir needed to add the rest of arguments. Tokens are preprocessed like in the
+     * full parse ('@file', '=', aliases, combined and contiguous args), so the pass copies argv.
+     * Values can be obtained right after it. The full parse (parseArgs() etc.) starts over and parses them again.
+     * Values of sink/appendTo arguments are delivered by the full parse only.
+     * Returns number of options found
+     */
+    int parseBootstrap(int argc, char *argv[])
+    {
+        prepareParse(argc, argv, __func__);
+        m_bootstrapped = true;
+        m_argVec.assign(argv + 1, argv + argc);
+        expandResponseFiles();
+        if(m_allow_abbrev){
+            buildAbbrevIndex();
         }
-        ///Retrieve binary self-name
-        if(m_binary_name.empty()){
-            std::string self_name = std::string(argv[0]);
-            size_t pos = self_name.find_last_of("/\\"); // Handles both Windows and UNIX
-            m_binary_name = (pos == std::string::npos) ? self_name : self_name.substr(pos + 1);
+        checkTokensLimit(m_argVec.size());
+        setParseCounters();
+        parsePreprocessArgVec();
+        // '=' and contiguous values are marked with leading \0 by preprocessing
+        auto isValue = [](const std::string &x){
+            return !x.empty() && x.front() == '\0';
+        };
+        int found = 0;
+        std::vector<std::string> values;
+        for(size_t i = 0; i < m_argVec.size(); ++i){
+            const auto &token = m_argVec[i];
+            // arguments of commands and after '--' aren't ours
+            if(token == "--" || findChildByName(token) != nullptr){
+                break;
+            }
+            // aliases are replaced with keys, unknown tokens are skipped one by one, their arity isn't known yet
+            const auto known = m_argMap.find(token);
+            if(known == m_argMap.end() || known->first == help_key || known->second->m_positional){
+                continue;
+            }
+            const auto &name = known->first;
+            const auto &arg = known->second;
+            values.clear();
+            if(arg->m_options_count == 0 && i + 1 < m_argVec.size() && isValue(m_argVec[i + 1])){
+                // '=' value for flag
+                ++i;
+                continue;
+            }
+            while(i + 1 < m_argVec.size() && (arg->isVariadic() || values.size() < arg->m_options_count)){
+                const auto &next = m_argVec[i + 1];
+                if(isValue(next)){
+                    values.emplace_back(next, 1);
+                    ++i;
+                    continue;
+                }
+                const bool option_like = next.size() > 1 && next[0] == '-' && !std::isdigit(static_cast<unsigned char>(next[1]));
+                if(values.size() >= size_t(arg->m_mandatory_options) && (option_like || next == "--" || findChildByName(next) != nullptr)){
+                    break;
+                }
+                values.push_back(next);
+                ++i;
+            }
+            if(values.size() < size_t(arg->m_mandatory_options)){
+                throw parse_error(name + " requires " + std::to_string(arg->m_mandatory_options)
+                                  + " parameters, but " + std::to_string(values.size()) + " were provided");
+            }
+            if(arg->m_set && !arg->m_repeatable){
+                throw parse_error("Error: redefinition of non-repeatable arg " + name);
+            }
+            if(arg->m_arg_handle->has_sink()){
+                // values are consumed, but pushed by the full parse only, so they aren't delivered twice
+                ++found;
+                continue;
+            }
+            // deferred action reads values on first access, keep them until the full parse
+            const auto &args = arg->m_lazy ? m_bootstrap_values.emplace_back(std::move(values)) : values;
+            try{
+                arg->m_arg_handle->action(args.data(), int(args.size()));
+            }catch(std::exception &e){
+                throw unparsed_param(name, e.what(), args);
+            }catch(...){
+                throw unparsed_param(name, "unknown error", args);
+            }
+            setArgument(name);
+            ++found;
         }
-        try{
-            return parseArgs({argv + 1, argv + argc});
-        }catch(const parse_error &e){
-            std::cout << e.what() << std::endl;
-            std::cout << "Try '" << help_key << "' for more information" << std::endl;
-            throw;
+        return found;
+    }
+
+    /**
+     * Parse arguments, passing through unknown ones and everything after '--' instead of failing.
+     * Passed through arguments are available with unknownArgs()
+     */
+    int parseKnownArgs(int argc, char *argv[])
+    {
+        prepareParse(argc, argv, __func__);
+        // reused if parser is reset, keeping capacity for bulk parsing
+        if(m_known_args == nullptr){
+            m_known_args = std::make_unique<knownArgs>();
+        }
+        m_known_args->clear();
+        m_known_args->argv = argv + 1;
+        struct passThroughGuard{
+            argParser &parser;
+            ~passThroughGuard(){ parser.m_pass_through = nullptr; }
+        } guard{*this};
+        m_pass_through = m_known_args.get();
+        auto res = parseAndReport({argv + 1, argv + argc});
+        auto &args = m_known_args->args;
+        args.insert(args.end(), m_known_args->tail.begin(), m_known_args->tail.end());
+        args.push_back(nullptr);
+        return res;
+    }
+
+    /**
+     * Parse NUL-separated command line starting with binary name, e.g. contents of /proc/<pid>/cmdline.
+     * Buffer is moved into the parser, so unknownArgs() can point into it. Tokens are copied to strings
+     * as with parseArgs(). If known_only, unknown arguments are passed through
+     * as with parseKnownArgs() (so host program's options are ignored)
+     */
+    int parseCmdline(std::string &&buffer, bool known_only = true)
+    {
+        // arguments of the last parse may point into the buffer
+        repeatedParseCheck(__func__);
+        checkBytesLimit(buffer.size());
+        m_cmdline = std::move(buffer);
+        m_cmdline_argv.clear();
+        char *p = m_cmdline.data();
+        char *end = p + m_cmdline.size();
+        while(p < end){
+            m_cmdline_argv.push_back(p);
+            p = static_cast<char*>(std::memchr(p, '\0', size_t(end - p)));
+            if(p == nullptr){
+                break;
+            }
+            ++p;
         }
+        if(m_cmdline_argv.empty()){
+            // e.g. kernel threads, no binary name
+            m_cmdline_argv.push_back(m_cmdline.data());
+        }
+        const int argc = int(m_cmdline_argv.size());
+        m_cmdline_argv.push_back(nullptr);
+        return known_only ? parseKnownArgs(argc, m_cmdline_argv.data()) : parseArgs(argc, m_cmdline_argv.data());
     }
 
+    /// Read command line from file (own one by default) and parse it with parseCmdline()
+    int parseProcCmdline(const std::string &path = "/proc/self/cmdline", bool known_only = true)
+    {
+        std::string buffer;
+        // stop reading right after the limit
+        if(!parser_internal::readFile(path.c_str(), buffer, m_limits.max_bytes)){
+            throw std::runtime_error(std::string(__func__) + ": cannot read " + path);
+        }
+        return parseCmdline(std::move(buffer), known_only);
+    }
+
+    /// Forget parsed values (commands too), so the same parser can parse another command line
+    void resetParse()
+    {
+        resetParseState();
+        m_bootstrapped = false;
+        for(const auto &x : m_commandMap){
+            x.second->resetParse();
+        }
+    }
+
+    /// Arguments passed through by parseKnownArgs(): original argv pointers, null-terminated (can be passed to execv)
+    [[nodiscard]] char *const *unknownArgs() const {
+        parsedCheck(__func__);
+        static char *const empty[] = {nullptr};
+        return m_known_args ? m_known_args->args.data() : empty;
+    }
+
+    /// Number of arguments passed through by parseKnownArgs()
+    [[nodiscard]] size_t unknownArgsCount() const {
+        parsedCheck(__func__);
+        return m_known_args ? m_known_args->args.size() - 1 : 0;
+    }
+
+    /// Parse arguments from a single string (without binary name), split as a POSIX shell would do it
+    int parseCommandLine(std::string_view line)
+    {
+        checkBytesLimit(line.size());
+        std::deque<std::string> unescaped;
+        auto tokens = splitCommandLine(line, unescaped);
+        prepareParse(tokens.size(), __func__);
+        return parseAndReport({tokens.begin(), tokens.end()});
+    }
+
+    /**
+     * Split command line string like a POSIX shell: whitespace separates tokens, quotes and backslash escapes are removed.
+     * No expansions are done. Tokens point into 'line', except for those containing quotes or escapes,
+     * which are stored in 'unescaped'. Throws parse_error if a quote is not closed or line ends with backslash
+     */
+    static std::vector<std::string_view> splitCommandLine(std::string_view line, std::deque<std::string> &unescaped){
+        using parser_internal::findAnyOf;
+        std::vector<std::string_view> tokens;
+        const char *p = line.data();
+        const char *end = p + line.size();
+        std::string token;
+        while(true){
+            // line continuation between tokens is whitespace, it doesn't start an empty token
+            while(p < end && (parser_internal::isShellSpace(*p) || (*p == '\\' && p + 1 < end && p[1] == '\n'))){
+                p += *p == '\\' ? 2 : 1;
+            }
+            if(p == end){
+                break;
+            }
+            const char *start = p;
+            bool plain = true;
+            while(true){
+                const char *next = findAnyOf<' ', '\t', '\n', '\r', '\v', '\f', '\'', '"', '\\'>(p, end);
+                if(!plain){
+                    token.append(p, next);
+                }
+                p = next;
+                if(p == end || parser_internal::isShellSpace(*p)){
+                    break;
+                }
+                if(plain){
+                    // first quote or escape, copy from now on
+                    token.assign(start, p);
+                    plain = false;
+                }
+                if(*p == '\''){
+                    // no escapes inside single quotes
+                    const char *close = findAnyOf<'\''>(p + 1, end);
+                    if(close == end){
+                        throw parse_error("Unterminated quote in command line");
+                    }
+                    token.append(p + 1, close);
+                    p = close + 1;
+                }else if(*p == '"'){
+                    ++p;
+                    while(true){
+                        const char *special = findAnyOf<'"', '\\'>(p, end);
+                        token.append(p, special);
+                        if(special == end){
+                            throw parse_error("Unterminated quote in command line");
+                        }
+                        p = special + 1;
+                        if(*special == '"'){
+                            break;
+                        }
+                        // inside double quotes backslash escapes only $ ` " \ and newline
+                        if(p == end){
+                            throw parse_error("Unterminated quote in command line");
+                        }
+                        if(*p == '\n'){
+                            ++p;
+                        }else if(*p == '$' || *p == '`' || *p == '"' || *p == '\\'){
+                            token += *p++;
+                        }else{
+                            token += '\\';
+                        }
+                    }
+                }else{
+                    // backslash
+                    if(p + 1 == end){
+                        throw parse_error("Command line ends with escape character");
+                    }
+                    if(p[1] != '\n'){
+                        token += p[1];
+                    }
+                    p += 2;
+                }
+            }
+            if(plain){
+                tokens.emplace_back(start, size_t(p - start));
+            }else{
+                unescaped.push_back(std::move(token));
+                tokens.emplace_back(unescaped.back());
+                token.clear();
+            }
+        }
+        return tokens;
+    }
+
+    /**
+     * Parse arguments on a background thread.
+     * argv is copied before return. Callables and the callback run on the background thread,
+     * the callback runs after all values are set, right before the future becomes ready.
+     * Parser must not be used until then. Parse errors are thrown by future's get()
+     */
+    std::future<int> parseArgsAsync(int argc, char *argv[]){
+        prepareParse(argc, argv, __func__);
+        return std::async(std::launch::async, [this, args = std::vector<std::string>(argv + 1, argv + argc)]() mutable {
+            return parseAndReport(std::move(args));
+        });
+    }
+
+#ifdef __cpp_impl_coroutine
+    /**
+     * Same as parseArgsAsync(), for C++20 coroutines: co_await parser.parseArgsAwaitable(argc, argv)
+     * Coroutine is resumed on the background thread after the callback. Parser joins the thread when destroyed
+     */
+    auto parseArgsAwaitable(int argc, char *argv[]){
+        prepareParse(argc, argv, __func__);
+        joinWorker();
+        struct awaiter{
+            argParser &parser;
+            std::vector<std::string> args;
+            int result = 0;
+            std::exception_ptr error;
+
+            [[nodiscard]] bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle){
+                // not a std::async future: coroutine may finish (and destroy the awaiter) inside resume()
+                std::lock_guard<std::mutex> lock(parser.m_worker_mutex);
+                parser.m_worker = std::thread([this, handle]{
+                    {
+                        // resumed coroutine may destroy parser, thread should be stored by then
+                        std::lock_guard<std::mutex> stored(parser.m_worker_mutex);
+                    }
+                    try{
+                        result = parser.parseAndReport(std::move(args));
+                    }catch(...){
+                        error = std::current_exception();
+                    }
+                    handle.resume();
+                });
+            }
+            int await_resume(){
+                if(error){
+                    std::rethrow_exception(error);
+                }
+                return result;
+            }
+        };
+        return awaiter{*this, {argv + 1, argv + argc}, 0, nullptr};
+    }
+#endif
+
     /// Returns true if arguments were fully parsed
     [[nodiscard]] bool parsed() const noexcept {
         return m_args_parsed;
     }
 
+    /// Publish parsed values for lock-free readers and allow reload(). Plain (non-atomic) global pointers are not allowed
+    argParser &liveReload(bool enable = true){
+        if(enable){
+            for(const auto *arg : m_argById){
+                checkLiveArgument(*arg, __func__);
+            }
+        }
+        m_live = enable;
+        return *this;
+    }
+
+    /**
+     * Latest published values. Lock-free, can be called from any thread.
+     * Returned snapshot keeps them alive (reload() frees retired values once no snapshot refers to them),
+     * so it should be released when done and must not outlive the parser
+     */
+    [[nodiscard]] auto values() const {
+        // register as reader of current epoch before loading values, so they can't be freed in between
+        size_t slot;
+        while(true){
+            const auto epoch = m_epoch.load();
+            slot = epoch & 1;
+            m_readers[slot].fetch_add(1);
+            if(m_epoch.load() == epoch){
+                break;
+            }
+            m_readers[slot].fetch_sub(1, std::memory_order_release);
+        }
+        auto published = m_values.load();
+        if(published == nullptr){
+            m_readers[slot].fetch_sub(1, std::memory_order_release);
+            throw std::runtime_error(std::string(__func__) + ": Invalid call. No values published (liveReload() not enabled or arguments not parsed yet)");
+        }
+        return ValuesSnapshot(published, &m_readers[slot]);
+    }
+
+    /// Re-parse arguments at runtime. New values are published only if the whole command line is valid
+    int reload(int argc, char *argv[]){
+        checkTokensLimit(argc > 0 ? argc - 1 : 0);
+        checkArgvBytes(argc, argv);
+        return reload({argv + 1, argv + argc});
+    }
+
     const Argument &operator [] (const std::string &key) const { return getArg(key); }
 
     /// Custom exception class (unparsed parameters)
@@ -1077,6 +2412,195 @@ public:
         explicit parse_error(const std::string& s) : std::runtime_error(s){}
     };
 
+    /// Hard limits for untrusted command lines (0 = unlimited)
+    struct Limits{
+        size_t max_tokens = 0;          // number of tokens (after combined args are split)
+        size_t max_bytes = 0;           // total size of arguments (of string for parseCommandLine/parseCmdline)
+        size_t max_values = 0;          // values of a single nargs/variadic argument
+        size_t max_command_depth = 0;   // nesting of commands
+        size_t max_typo_work = 0;       // characters compared while searching for typos
+    };
+    /// Parse error thrown when one of the limits is exceeded
+    class limit_error : public parse_error{
+    public:
+        enum class limit {TOKENS, BYTES, VALUES, COMMAND_DEPTH, TYPO_WORK};
+        explicit limit_error(limit which, size_t maximum, const std::string &msg)
+                : parse_error(msg), m_which(which), m_maximum(maximum) {}
+        [[nodiscard]] limit which() const noexcept { return m_which; }
+        [[nodiscard]] size_t maximum() const noexcept { return m_maximum; }
+    private:
+        limit m_which;
+        size_t m_maximum;
+    };
+
+    /**
+     * Run callables of parallel() arguments on background threads while parsing (commands use it too).
+     * At most max_threads of them run at once (0: hardware concurrency), the oldest one is waited for before starting another
+     */
+    argParser &parallelActions(bool enable = true, size_t max_threads = 0){
+        m_parallel_actions = enable;
+        m_max_parallel = max_threads != 0 ? max_threads : std::max(1u, std::thread::hardware_concurrency());
+        return *this;
+    }
+
+    /**
+     * Replace '@file' tokens with arguments read from file (GCC style response files).
+     * Files are split like command line strings and may contain other '@file' tokens, up to max_depth levels.
+     * Token is left as is if file can't be opened
+     */
+    argParser &responseFiles(bool enable = true, size_t max_depth = 8){
+        m_response_files = enable;
+        m_response_depth = max_depth;
+        return *this;
+    }
+
+    /// Accept unambiguous prefixes of long options and command names (--verb for --verbose). Commands use it too
+    argParser &allowAbbrev(bool enable = true){
+        m_allow_abbrev = enable;
+        return *this;
+    }
+
+    /// Set limits enforced while parsing (commands use them too)
+    argParser &setLimits(const Limits &limits){
+        m_limits = limits;
+        return *this;
+    }
+
+    /// At most one of the arguments can be specified (exactly one if 'required')
+    argParser &addExclusiveGroup(const std::vector<std::string> &keys, bool required = false){
+        if(keys.size() < 2){
+            throw std::invalid_argument(std::string(__func__) + ": group should have at least 2 arguments");
+        }
+        m_constraints.push_back({constraint::kind::EXCLUSIVE, 0, constraintMask(keys, __func__), required});
+        return *this;
+    }
+
+    /// If 'key' is specified, all of 'required_keys' should be specified too
+    argParser &addDependency(const std::string &key, const std::vector<std::string> &required_keys){
+        addRelation(constraint::kind::DEPENDENCY, key, required_keys, __func__);
+        return *this;
+    }
+
+    /// If 'key' is specified, none of 'conflicting_keys' can be specified
+    argParser &addConflict(const std::string &key, const std::vector<std::string> &conflicting_keys){
+        addRelation(constraint::kind::CONFLICT, key, conflicting_keys, __func__);
+        return *this;
+    }
+
+    /// Immutable set of values published by a live parser
+    class Values{
+    public:
+        template <typename T>
+        T getValue(const std::string &key) const {
+            try{
+                return std::any_cast<T>(find(key, __func__).get());
+            }catch(const std::bad_any_cast& e){
+                throw std::invalid_argument(std::string(__func__) + ": " + key + " cannot cast to " + parser_internal::GetTypeName<T>());
+            }
+        }
+        [[nodiscard]] bool isSet(const std::string &key) const {
+            return find(key, __func__).set;
+        }
+        /// Incremented each time new values are published
+        [[nodiscard]] unsigned long version() const noexcept {
+            return m_version;
+        }
+    private:
+        friend class argParser;
+        struct deferredValue{
+            std::function<std::any()> compute;
+            std::once_flag once;
+            std::any value;
+        };
+        struct Entry{
+            std::any value;
+            bool set = false;
+            std::shared_ptr<deferredValue> deferred; // default provider, run by the first reader
+
+            [[nodiscard]] const std::any &get() const {
+                if(!deferred){
+                    return value;
+                }
+                std::call_once(deferred->once, [this]{ deferred->value = deferred->compute(); });
+                return deferred->value;
+            }
+        };
+        std::map<std::string, Entry> m_entries;
+        std::map<std::string, std::string> m_aliases;
+        unsigned long m_version = 0;
+        std::vector<std::string> m_args; // tokens which published const char* values point to
+
+        [[nodiscard]] const Entry &find(const std::string &key, const char *func) const {
+            auto it = m_entries.find(key);
+            if(it == m_entries.end()){
+                auto alias = m_aliases.find(key);
+                if(alias != m_aliases.end()){
+                    it = m_entries.find(alias->second);
+                }
+            }
+            if(it == m_entries.end()){
+                throw std::invalid_argument(std::string(func) + ": " + key + " not defined");
+            }
+            return it->second;
+        }
+    };
+
+    /// Values published by a live parser, pinned while the snapshot exists
+    class ValuesSnapshot{
+    public:
+        ValuesSnapshot(ValuesSnapshot &&other) noexcept
+                : m_values(other.m_values), m_readers(std::exchange(other.m_readers, nullptr)) {}
+        ValuesSnapshot(const ValuesSnapshot&) = delete;
+        ValuesSnapshot &operator=(const ValuesSnapshot&) = delete;
+        ValuesSnapshot &operator=(ValuesSnapshot&&) = delete;
+        ~ValuesSnapshot(){
+            if(m_readers != nullptr){
+                m_readers->fetch_sub(1, std::memory_order_release);
+            }
+        }
+        template <typename T>
+        T getValue(const std::string &key) const {
+            return m_values->getValue<T>(key);
+        }
+        [[nodiscard]] bool isSet(const std::string &key) const {
+            return m_values->isSet(key);
+        }
+        [[nodiscard]] unsigned long version() const noexcept {
+            return m_values->version();
+        }
+        const Values &operator*() const noexcept {
+            return *m_values;
+        }
+        const Values *operator->() const noexcept {
+            return m_values;
+        }
+    private:
+        friend class argParser;
+        ValuesSnapshot(const Values *values, std::atomic<size_t> *readers) noexcept
+                : m_values(values), m_readers(readers) {}
+        const Values *m_values;
+        std::atomic<size_t> *m_readers; // reader count of the epoch it was taken in
+    };
+
+    /// Values of options below dotted prefix (e.g. "db.primary" for "--db.primary.host"), keyed by the rest of their path ("host")
+    [[nodiscard]] Values getNamespace(std::string_view prefix) const {
+        parsedCheck(__func__);
+        prefix.remove_prefix(std::min(prefix.find_first_not_of('-'), prefix.size()));
+        Values res;
+        const bool found = m_namespaces.forEach(prefix, [&](std::string_view path, std::string_view key){
+            const auto &arg = m_argMap.find(key)->second;
+            res.m_entries.emplace(std::string(path), Values::Entry{arg->m_arg_handle->get_any_val(), arg->m_set, nullptr});
+        });
+        if(!found){
+            throw std::invalid_argument(std::string(__func__) + ": " + std::string(prefix) + " not defined");
+        }
+        if(res.m_entries.empty()){
+            // leaf option or path of an alias
+            throw std::invalid_argument(std::string(__func__) + ": " + std::string(prefix) + " is not a namespace");
+        }
+        return res;
+    }
+
 protected:
     friend class ArgBuilderBase;
     enum class IS_REQUIRED {
@@ -1085,10 +2609,18 @@ protected:
         TRUE
     };
 
-    std::map<std::string, std::unique_ptr<Argument>> m_argMap;
-    std::map<std::string, std::unique_ptr<argParser>> m_commandMap;
+    // declared before arguments, they keep views to it
+    parser_internal::stringPool m_strings;
+    std::map<std::string, std::unique_ptr<Argument>, std::less<>> m_argMap;
+    std::map<std::string, std::unique_ptr<argParser>, std::less<>> m_commandMap;
+    std::map<std::string, std::string, std::less<>> m_aliasMap; // alias -> key
+    parser_internal::segmentTrie m_namespaces; // option paths split by '.'
     std::vector<std::string> m_posMap;
     std::vector<std::string> m_argVec;
+    // last findNextArg() lookup: no non-positional keys in [m_next_arg_from, m_next_arg)
+    int m_next_arg_from = 0;
+    int m_next_arg = -1;
+    std::vector<size_t> m_distance_rows; // typo detection buffer
     std::function<void()> m_callback;
 
     std::string m_binary_name;
@@ -1096,30 +2628,146 @@ protected:
     inline static std::string help_hidden_secret;
     inline static const std::string help_key = "--help";
     inline static const std::string help_alias = "-h";
+#ifdef ARGPARSER_INSTRUMENTATION
+    parseObserver *m_observer = nullptr;
+    size_t m_conversions = 0;
+#endif
+    Limits m_limits;
+    bool m_parallel_actions = false;
+    bool m_response_files = false;
+    bool m_allow_abbrev = false;
+    parser_internal::prefixTrie m_abbrev;   // long keys, aliases and commands, built on parse if abbreviations allowed
+    size_t m_abbrev_words = 0;              // number of arguments and commands in m_abbrev
+    size_t m_response_depth = 0;
+    /// Arguments passed through by parseKnownArgs, shared with commands
+    struct knownArgs{
+        char **argv = nullptr;              // arguments after binary name
+        std::deque<std::string> expanded;   // tokens read from response files
+        std::vector<char*> args;            // unknown tokens
+        std::vector<char*> tail;            // tokens after '--'
+        int last_origin = std::numeric_limits<int>::min();
+        void clear(){
+            expanded.clear();
+            args.clear();
+            tail.clear();
+            last_origin = std::numeric_limits<int>::min();
+        }
+        // non-negative origin is argv index, negative one is index of expanded token
+        char *token(int origin){
+            return origin >= 0 ? argv[origin] : &expanded[size_t(-origin - 1)][0];
+        }
+    };
+    std::unique_ptr<knownArgs> m_known_args;
+    std::string m_cmdline;              // buffer of parseCmdline()
+    std::vector<char*> m_cmdline_argv;  // arguments in m_cmdline
+    knownArgs *m_pass_through = nullptr; // set while parsing known args
+    std::vector<int> m_arg_origin; // origin of each token in m_argVec while parsing known args
+    struct parallelAction{
+        std::string key;
+        int start;
+        int end;
+        std::future<void> result;
+    };
+    std::vector<parallelAction> m_parallel; // actions running in background
+    size_t m_max_parallel = 1;     // actions running at the same time
+    size_t m_parallel_waited = 0;  // actions in m_parallel known to be finished
+    std::thread m_worker; // thread of parseArgsAwaitable()
+    std::mutex m_worker_mutex;
+    size_t m_depth = 0; // command nesting level
+    size_t m_typo_work = 0;
+    size_t m_input_bytes = 0; // size of arguments and response files read so far
     bool m_args_parsed = false;
+    bool m_bootstrapped = false; // parseBootstrap() was called, full parse not started yet
+    std::vector<std::vector<std::string>> m_bootstrap_values; // values of lazy arguments found by parseBootstrap()
+    bool m_live = false;
+    bool m_reloading = false;
+    // published values. Replaced ones are retired and freed once readers of the epoch they were retired in are gone
+    std::atomic<const Values*> m_values {nullptr};
+    std::unique_ptr<Values> m_published;
+    std::array<std::vector<std::unique_ptr<Values>>, 2> m_retired; // by epoch parity
+    std::atomic<size_t> m_epoch {0};
+    mutable std::array<std::atomic<size_t>, 2> m_readers {}; // snapshots taken in epoch, by epoch parity
     bool m_mandatory_option = false;
     bool m_command_parsed = false;
     int m_positional_args_parsed = 0;
     int m_unparsed_mandatory_positionals = 0;
-    int m_mandatory_args = 0;
-    int m_required_args = 0;
-    int m_hidden_args = 0;
     int m_command_offset = 0;
-    int m_parsed_mnd_args = 0;
-    int m_parsed_required_args = 0;
+    // flat argument table indexed by Argument::m_id, whole-spec passes walk it instead of map nodes.
+    // Map stays for lookup by key and ordered help
+    std::vector<Argument*> m_argById;
+    // dispatch table for combined/contiguous args: [starts with '-'][key char] -> id + 1 of single char key, 0 if none
+    std::array<std::array<uint32_t, 256>, 2> m_short_options{};
+    // [starts with '-'][char] -> some longer key, alias or command starts with it
+    std::array<std::bitset<256>, 2> m_long_keys;
+    parser_internal::dynamicBitset m_mandatory_mask; // non-positional mandatory
+    parser_internal::dynamicBitset m_required_mask;
+    parser_internal::dynamicBitset m_set_mask;
+    // relations between arguments, checked after parsing
+    struct constraint{
+        enum class kind {EXCLUSIVE, DEPENDENCY, CONFLICT};
+        kind type;
+        size_t arg; // DEPENDENCY, CONFLICT: id of the argument which triggers the check
+        parser_internal::dynamicBitset mask;
+        bool required; // EXCLUSIVE: one of them should be specified
+    };
+    std::vector<constraint> m_constraints;
+
+    void registerArgument(const std::string &key, std::unique_ptr<Argument> &&arg) {
+        if(m_live){
+            checkLiveArgument(*arg, "finalize");
+        }
+        if(arg->m_lazy){
+            // deferred errors are reported as if they were thrown while parsing
+            arg->m_arg_handle->make_lazy([key](const char *what, const std::string *args, int size){
+                return std::make_exception_ptr(unparsed_param(key, what, {args, args + size}));
+            });
+        }
+        arg->m_id = m_argById.size();
+        m_argById.push_back(arg.get());
+        m_mandatory_mask.set(arg->m_id, !arg->m_optional && !arg->m_positional);
+        m_required_mask.set(arg->m_id, arg->m_optional && arg->m_required);
+        m_set_mask.resize(m_argById.size());
+        indexShortKey(key, arg->m_id);
+        for(const auto &alias : arg->m_aliases){
+            indexShortKey(alias, arg->m_id);
+        }
+        const auto &stored = *m_argMap.emplace(key, std::move(arg)).first;
+        if(!stored.second->m_positional){
+            // map keys are stable, trie keeps views to them
+            if(stored.first.find('.') != std::string::npos){
+                m_namespaces.insert(namespacePath(stored.first), stored.first);
+            }
+            // dotted aliases aren't listed, but their paths are taken
+            for(const auto &alias : stored.second->m_aliases){
+                if(alias.find('.') != std::string::npos){
+                    m_namespaces.insert(namespacePath(alias), stored.first, /*alias=*/true);
+                }
+            }
+        }
+    }
+
+    /// Single char keys ("-v" or "v") go to the dispatch table, first chars of longer ones are marked
+    void indexShortKey(std::string_view key, size_t id) {
+        const bool minus = key.front() == '-';
+        const size_t short_len = minus ? 2 : 1;
+        if(key.size() < short_len){
+            return;
+        }
+        const auto c = static_cast<unsigned char>(key[short_len - 1]);
+        if(key.size() == short_len){
+            m_short_options[minus][c] = uint32_t(id + 1);
+        }else{
+            m_long_keys[minus].set(c);
+        }
+    }
 
     [[nodiscard]] Argument &getArg(const std::string &key) const {
         auto it = m_argMap.find(key);
         if (it == m_argMap.end()) {
-            it = [&key, this]() {
-                for(auto x = m_argMap.begin(); x != m_argMap.end(); ++x) {
-                    const auto &aliases = x->second->m_aliases;
-                    if (std::find(aliases.begin(), aliases.end(), key) != aliases.end()) {
-                        return x;
-                    }
-                }
-                return m_argMap.end();
-            }();
+            auto alias = m_aliasMap.find(key);
+            if(alias != m_aliasMap.end()){
+                it = m_argMap.find(alias->second);
+            }
         }
         if(it != m_argMap.end()){
             return *it->second;
@@ -1141,57 +2789,92 @@ protected:
             func = __func__;
         }
         //Check previous definition
-        if(m_argMap.find(key) != m_argMap.end()){
+        if(m_argMap.find(key) != m_argMap.end() || m_aliasMap.find(key) != m_aliasMap.end()){
             throw std::invalid_argument(std::string(func) + ": " + std::string(key) + " already defined");
         }
-        for(const auto &x : m_argMap){
-            for(const auto &alias : x.second->m_aliases){
-                if(alias == key){
-                    throw std::invalid_argument(std::string(func) + ": " + std::string(key) + " already defined");
-                }
+    }
+
+    static std::string_view namespacePath(std::string_view key) {
+        return key.substr(key.find_first_not_of('-'));
+    }
+
+    /// Dotted keys and aliases are indexed by path without leading '-', so "-db.host" and "--db.host" cannot both be defined
+    void checkNamespaceDuplicates(const std::string &key, const std::vector<std::string> &aliases, const char *func) const {
+        std::map<std::string_view, const std::string*> paths; // of the new argument
+        auto check = [&](const std::string &name){
+            if(name.find('.') == std::string::npos){
+                return;
             }
-        }
+            const auto path = namespacePath(name);
+            auto existing = m_namespaces.find(path);
+            if(!existing.empty()){
+                throw std::invalid_argument(std::string(func) + ": " + name + " namespace path already defined by " + std::string(existing));
+            }
+            auto same = paths.emplace(path, &name);
+            if(!same.second){
+                throw std::invalid_argument(std::string(func) + ": " + name + " namespace path already defined by " + *same.first->second);
+            }
+        };
+        check(key);
+        std::for_each(aliases.begin(), aliases.end(), check);
     }
 
     size_t calculateMismatch (const std::string &target, const std::string &candidate) {
         // use Levenstein distance
         auto targetLen = target.length();
         auto candidateLen = candidate.length();
+        // distance is at least the difference in length, no need to compute it exactly
+        // if it's already too big to be considered a typo
+        auto lenDiff = targetLen > candidateLen ? targetLen - candidateLen : candidateLen - targetLen;
+        if (lenDiff > 1) {
+            return lenDiff;
+        }
+        m_typo_work += (targetLen + 1) * (candidateLen + 1);
+        if(m_limits.max_typo_work && m_typo_work > m_limits.max_typo_work){
+            throw limit_error(limit_error::limit::TYPO_WORK, m_limits.max_typo_work,
+                              "Typo detection exceeded limit of " + std::to_string(m_limits.max_typo_work) + " compared characters");
+        }
         // distanceTable[i][j] is the minimum number of edits (Levenstein distance) required to convert
         // the first i chars of target into the first j chars of candidate
-        std::vector<std::vector<size_t>> distanceTable(targetLen + 1, std::vector<size_t>(candidateLen + 1));
+        // only last 3 rows are needed (current, previous and the one before for transpositions),
+        // they are kept in a reusable buffer to avoid allocations
+        const auto width = candidateLen + 1;
+        m_distance_rows.resize(3 * width);
+        auto row = [this, width](size_t i) { return &m_distance_rows[(i % 3) * width]; };
         // base case - one string is empty
         // (to convert first i chars of target into empty string requires i deletions)
-        for (auto i = 0; i <= targetLen; ++i) distanceTable[i][0] = i; // Default deletion cost
-        for (auto j = 0; j <= candidateLen; ++j) distanceTable[0][j] = j; // Default insertion cost
+        for (size_t j = 0; j <= candidateLen; ++j) row(0)[j] = j; // Default insertion cost
         // populate distanceTable table
-        for (auto tIdx = 1; tIdx <= targetLen; ++tIdx) {
-            for (auto cIdx = 1; cIdx <= candidateLen; ++cIdx) {
+        for (size_t tIdx = 1; tIdx <= targetLen; ++tIdx) {
+            auto cur = row(tIdx);
+            auto prev = row(tIdx - 1);
+            cur[0] = tIdx; // Default deletion cost
+            for (size_t cIdx = 1; cIdx <= candidateLen; ++cIdx) {
                 char targetChar = target[tIdx - 1];
                 char candidateChar = candidate[cIdx - 1];
                 if (targetChar == candidateChar) {
                     //if chars match, no edit needed, copy previous value
-                    distanceTable[tIdx][cIdx] = distanceTable[tIdx - 1][cIdx - 1];
+                    cur[cIdx] = prev[cIdx - 1];
                 } else {
                     // if don't match, figure out which operation is less costly
-                    size_t insertionCost = distanceTable[tIdx][cIdx - 1] + 1;
-                    size_t deletionCost = distanceTable[tIdx - 1][cIdx] + 1;
-                    size_t substitutionCost = distanceTable[tIdx - 1][cIdx - 1] + 1;
-                    distanceTable[tIdx][cIdx] = std::min({insertionCost,deletionCost,substitutionCost});
+                    size_t insertionCost = cur[cIdx - 1] + 1;
+                    size_t deletionCost = prev[cIdx] + 1;
+                    size_t substitutionCost = prev[cIdx - 1] + 1;
+                    cur[cIdx] = std::min({insertionCost,deletionCost,substitutionCost});
                 }
                 // check transpositions (swapped adjacent chars)
                 if (tIdx > 1 && cIdx > 1) {
                     char prevTargetChar = target[tIdx-2];
                     char prevCandidateChar = candidate[cIdx-2];
                     if (targetChar == prevCandidateChar && candidateChar == prevTargetChar) {
-                        size_t transpositionCost = distanceTable[tIdx-2][cIdx-2] + 1;
-                        distanceTable[tIdx][cIdx] = std::min(distanceTable[tIdx][cIdx], transpositionCost);
+                        size_t transpositionCost = row(tIdx - 2)[cIdx-2] + 1;
+                        cur[cIdx] = std::min(cur[cIdx], transpositionCost);
                     }
                 }
             }
         }
         // return result
-        return distanceTable[targetLen][candidateLen];
+        return row(targetLen)[candidateLen];
     }
 
     size_t calculateLexMismatch (const std::string &s1, const std::string &s2) {
@@ -1247,7 +2930,7 @@ protected:
         return minMismatch < 2 ? closestMatch : "";
     };
 
-    [[nodiscard]] argParser* findChildByName (const std::string &key) const {
+    [[nodiscard]] argParser* findChildByName (std::string_view key) const {
             const auto &it = m_commandMap.find(key);
             if (it != m_commandMap.end()) {
                 return it->second.get();
@@ -1266,74 +2949,178 @@ protected:
         return false;
     }
 
-    bool parseHandleContiguousAndCombinedArgs(std::string &pName, std::string &pValue, std::string &name) {
-        auto len = pName.front() == '-' ? 2 : 1;
-        std::string startsWith = pName.substr(0, len);
-        if(m_argMap.find(startsWith) != m_argMap.end()){
-            name = startsWith;
-        }else{
-            name = findKeyByAlias(startsWith);
-        }
-        if(!name.empty()){
-            const auto &x = m_argMap.at(name);
+    /// Split combined (-vvv/-it or vvv/it style) and contiguous (-k123 or k123 style) args into result.
+    /// Returns key of the last recognized argument, or empty string if token wasn't recognized
+    std::string parseHandleContiguousAndCombinedArgs(std::string &pName, std::vector<std::string> &result,
+                                                     parser_internal::pendingTokens &pending) {
+        const Argument *last = nullptr; // last recognized argument
+        auto lastKey = [&last]() {
+            return last != nullptr ? last->m_name : std::string();
+        };
+        size_t offset = 0; // start of unprocessed portion of pName
+        while(offset < pName.size()){
+            std::string_view rest(pName);
+            rest.remove_prefix(offset);
+            const bool minus = rest.front() == '-';
+            const size_t short_len = minus ? 2 : 1;
+            if(rest.size() < short_len){
+                break;
+            }
+            const auto c = static_cast<unsigned char>(rest[short_len - 1]);
+            const auto id = m_short_options[minus][c];
+            // remainder which is a key, alias or command itself is processed as a separate token.
+            // Map lookups only if some longer key or command starts with the same char
+            if(offset > 0 && ((id != 0 && rest.size() == short_len)
+                              || (m_long_keys[minus].test(c) && (!findKeyByAlias(rest).empty() || findChildByName(rest) != nullptr)))){
+                pending.push(std::string(rest));
+                return lastKey();
+            }
+            if(id == 0){
+                break;
+            }
+            const Argument *x = m_argById[id - 1];
             if(x->m_implicit){
-                // implicit contiguous (-vvv/-it or vvv/it style) argument
-                //set '-' to other portion to extract it later
-                pValue = x->m_starts_with_minus ? "-" : "";
-                pValue += pName.substr(startsWith.length());
-                return true;
-            } else if(!x->m_positional && x->m_options.size() == 1){
-                //check if it's a contiguous keyValue or aliasValue pair (-k123 or k123 style)
+                // implicit contiguous argument
+                checkTokensLimit(result.size() + 1);
+                result.push_back(x->m_name);
+                last = x;
+                offset += short_len;
+                if(x->m_starts_with_minus){
+                    // set '-' to other portion to extract it later.
+                    // It's done in place, so long clusters are not copied for each flag
+                    pName[--offset] = '-';
+                }
+            } else if(!x->m_positional && x->m_options_count == 1){
+                //check if it's a contiguous keyValue or aliasValue pair
                 //only for non-pos args with 1 option
-                pValue = pName.substr(startsWith.length());
-                pValue.insert(0, 1, '\0'); //add null to mark as value
-                pName = name;
-                return true;
+                result.push_back(x->m_name);
+                result.emplace_back(1, '\0'); //add null to mark as value
+                result.back() += rest.substr(short_len);
+                return x->m_name;
+            } else {
+                break;
             }
         }
-        return false;
+        // keep unrecognized portion as is
+        if(offset == 0){
+            result.push_back(std::move(pName));
+        } else if(offset < pName.size()){
+            result.emplace_back(pName, offset);
+        }
+        return lastKey();
     }
 
     void parsePreprocessArgVec() {
+        std::vector<std::string> result;
+        // '=' and contiguous values split into at most 2 tokens, only combined args may need more
+        result.reserve(2 * m_argVec.size());
+        // tokens produced from the current one, processed before the next input token (last one first).
+        // At most '=' value and remainder of combined args are pending at the same time
+        parser_internal::pendingTokens pending;
+        size_t next = 0;
+        // origins of result tokens for parseKnownArgs: tokens split from input token get its origin
+        std::vector<int> origins;
+        int origin = 0;
+        auto trackOrigins = [&]() {
+            if(m_pass_through != nullptr){
+                origins.resize(result.size(), origin);
+            }
+        };
+        auto hasNext = [&]() {
+            return !pending.empty() || next < m_argVec.size();
+        };
+        auto takeNext = [&]() {
+            if(!pending.empty()){
+                return pending.pop();
+            }
+            if(m_pass_through != nullptr){
+                origin = m_arg_origin[next];
+            }
+            return std::move(m_argVec[next++]);
+        };
+        auto copyNext = [&](int count) {
+            while(count-- > 0 && hasNext()){
+                trackOrigins();
+                result.push_back(takeNext());
+            }
+        };
+        // abbreviated command is expanded only where a command is dispatched:
+        // not as optional value of the last argument and not as mandatory positional
+        size_t value_slots = 0; // optional values the last argument can still take
+        int positionals = 0;    // tokens which are neither keys nor values
+        auto optionalValues = [](const Argument &arg) {
+            return arg.isVariadic() ? std::numeric_limits<size_t>::max() : arg.m_options_count - size_t(arg.m_mandatory_options);
+        };
 
-        for(auto index = 0; index < m_argVec.size(); ++index){
-            auto insertKeyValue = [this, &index](const auto &key, const auto &val){
-                m_argVec[index] = key;
-                m_argVec.insert(m_argVec.begin() + index + 1, val);
-            };
-            std::string pName = m_argVec[index];
-            std::string pValue = index+1 >= m_argVec.size() ? "" : m_argVec[index + 1];
-
+        while(hasNext()){
+            checkTokensLimit(result.size());
+            trackOrigins();
+            std::string pName = takeNext();
+            std::string pValue;
             ///Handle '='
             if (parseHandleEqualsSign(pName, pValue)) {
-                //change current m_key and insert value to vector
-                insertKeyValue(pName, pValue);
+                //process value right after current key
+                pending.push(std::move(pValue));
             }
-            if(m_argMap.find(pName) == m_argMap.end()){
+            const auto known = m_argMap.find(pName);
+            if(known == m_argMap.end()){
                 ///Find alias
                 std::string name = findKeyByAlias(pName);
+                if(name.empty() && m_allow_abbrev && findChildByName(pName) == nullptr){
+                    const bool long_key = pName.size() > 2 && pName[0] == '-' && pName[1] == '-';
+                    const bool command = !pName.empty() && pName[0] != '-' && value_slots == 0
+                                         && positionals >= m_unparsed_mandatory_positionals;
+                    if((long_key || command) && expandAbbrev(pName)){
+                        name = findKeyByAlias(pName);
+                    }
+                }
                 if (findChildByName(pName) != nullptr) {
                     // if found child, break
-                    m_command_offset = m_argVec.size() - index;
+                    const auto child_idx = result.size();
+                    result.push_back(std::move(pName));
+                    copyNext(std::numeric_limits<int>::max());
+                    m_command_offset = int(result.size() - child_idx);
                     break;
                 } else if (!name.empty()) {
                     // change alias to key
-                    pName = name;
-                    m_argVec[index] = name;
-                    index += m_argMap[name]->m_mandatory_options; //skip mandatory opts
-                } else if (parseHandleContiguousAndCombinedArgs(pName, pValue, name)) {
+                    result.push_back(name);
+                    const auto &arg = *m_argMap[name];
+                    copyNext(arg.m_mandatory_options); //skip mandatory opts
+                    value_slots = optionalValues(arg);
+                } else {
                     ///check contiguous or combined arguments
-                    insertKeyValue(name, pValue);
+                    name = parseHandleContiguousAndCombinedArgs(pName, result, pending);
+                    if(!name.empty()){
+                        value_slots = 0;
+                    }else if(value_slots > 0){
+                        --value_slots;
+                    }else{
+                        ++positionals;
+                    }
+                }
+                if(name == help_key){
+                    // if found help key, break
+                    copyNext(std::numeric_limits<int>::max());
+                    break;
                 }
             } else{
                 // if found in argMap, skip mandatory opts
-                index += m_argMap[pName]->m_mandatory_options;
-            }
-            if(pName == help_key){
-                // if found help key, break
-                break;
+                result.push_back(std::move(pName));
+                copyNext(known->second->m_mandatory_options);
+                value_slots = optionalValues(*known->second);
+                if(known->first == help_key){
+                    // if found help key, break
+                    copyNext(std::numeric_limits<int>::max());
+                    break;
+                }
             }
         }
+        checkTokensLimit(result.size());
+        trackOrigins();
+        m_argVec = std::move(result);
+        if(m_pass_through != nullptr){
+            m_arg_origin = std::move(origins);
+        }
     }
 
     [[nodiscard]] int parseHandlePositional(int index) {
@@ -1376,7 +3163,25 @@ protected:
             /// Parse children
             auto child = findChildByName(m_argVec[index]);
             if(child != nullptr){
+#ifdef ARGPARSER_INSTRUMENTATION
+                if(child->m_observer == nullptr){
+                    child->m_observer = m_observer;
+                }
+#endif
+                child->m_limits = m_limits;
+                child->m_parallel_actions = m_parallel_actions;
+                child->m_max_parallel = m_max_parallel;
+                child->m_allow_abbrev = m_allow_abbrev;
+                child->m_depth = m_depth + 1;
+                if(m_limits.max_command_depth && child->m_depth > m_limits.max_command_depth){
+                    throw limit_error(limit_error::limit::COMMAND_DEPTH, m_limits.max_command_depth,
+                                      child->m_binary_name + ": commands nested deeper than " + std::to_string(m_limits.max_command_depth));
+                }
                 ++index; //skip command name itself
+                child->m_pass_through = m_pass_through;
+                if(m_pass_through != nullptr){
+                    child->m_arg_origin.assign(m_arg_origin.begin() + index, m_arg_origin.end());
+                }
                 index += child->parseArgs({m_argVec.begin() + index, m_argVec.end()});
                 m_command_parsed = true;
                 break;
@@ -1392,13 +3197,18 @@ protected:
     }
 
     int findNextArg(int index) {
-        for(auto i = index; i < m_argVec.size(); ++i) {
-            const auto &arg = m_argMap.find(m_argVec[i]);
+        // lookups go forward, so reuse previous result instead of rescanning the same tokens
+        if(index >= m_next_arg_from && index <= m_next_arg){
+            return m_next_arg;
+        }
+        m_next_arg_from = index;
+        for(m_next_arg = index; size_t(m_next_arg) < m_argVec.size(); ++m_next_arg) {
+            const auto &arg = m_argMap.find(m_argVec[m_next_arg]);
             if(arg != m_argMap.end() && !arg->second->m_positional){
-                return i;
+                break;
             }
         }
-        return m_argVec.size();
+        return m_next_arg;
     }
 
     int parseHandleKnownArg(int index, const std::string &pName) {
@@ -1419,7 +3229,7 @@ protected:
         const auto next_cmd_idx = m_argVec.size() - m_command_offset;
 
         while(++cnt < m_argVec.size()){
-            bool all_params_found = opts_cnt >= arg->m_options.size();
+            bool all_params_found = size_t(opts_cnt) >= arg->m_options_count;
             bool all_mandatory_found_or_variadic = (opts_cnt >= arg->m_mandatory_options) || arg->isVariadic();
             bool is_next_key = (cnt >= next_arg_idx || cnt >= next_cmd_idx);
             bool will_be_insufficient_for_positionals = (next_cmd_idx - cnt) <= m_unparsed_mandatory_positionals;
@@ -1445,28 +3255,145 @@ protected:
         return index;
     }
 
-    std::string findKeyByAlias(const std::string &key) {
+    void buildAbbrevIndex() {
+        const auto words = m_argMap.size() + m_commandMap.size();
+        if(words == m_abbrev_words){
+            return;
+        }
+        // only long keys and commands, short and non-minus keys are too easy to confuse with values
+        auto isLong = [](const std::string &x){
+            return x.size() > 2 && x[0] == '-' && x[1] == '-';
+        };
+        m_abbrev.clear();
         for(const auto &x : m_argMap){
-            if(x.first == key){
-                return key;
+            if(isLong(x.first)){
+                m_abbrev.insert(x.first, x.first);
             }
-            for(const auto &el : x.second->m_aliases){
-                if(el == key){
-                    return x.first;
+            for(const auto &alias : x.second->m_aliases){
+                if(isLong(alias)){
+                    m_abbrev.insert(alias, x.first);
                 }
             }
         }
-        return "";
+        for(const auto &x : m_commandMap){
+            m_abbrev.insert(x.first, x.first);
+        }
+        m_abbrev_words = words;
+    }
+
+    /// Replace abbreviated long key or command name with the full one. Returns false if token isn't an abbreviation
+    bool expandAbbrev(std::string &token) const {
+        if(token.empty() || (token[0] == '-' && (token.size() < 3 || token[1] != '-'))){
+            return false;
+        }
+        auto match = m_abbrev.resolve(token);
+        if(match.ambiguous){
+            std::string candidates;
+            for(const auto &x : m_abbrev.candidates(token)){
+                candidates += (candidates.empty() ? "" : ", ") + x;
+            }
+            throw parse_error("Ambiguous " + std::string(token[0] == '-' ? "argument" : "command") + ": " + token + " could match " + candidates);
+        }
+        if(match.target.empty()){
+            return false;
+        }
+        token = std::string(match.target);
+        return true;
+    }
+
+    std::string findKeyByAlias(std::string_view key) const {
+        if(m_argMap.find(key) != m_argMap.end()){
+            return std::string(key);
+        }
+        auto it = m_aliasMap.find(key);
+        return it != m_aliasMap.end() ? it->second : "";
     }
 
     void setArgument(const std::string &pName) {
         auto &arg = m_argMap[pName];
         arg->m_set = true;
-        //count mandatory/required options
-        if(!arg->m_optional){
-            m_parsed_mnd_args++;
-        }else if(arg->m_required){
-            m_parsed_required_args++;
+        m_set_mask.set(arg->m_id);
+    }
+
+    [[nodiscard]] size_t constraintArg(const std::string &key, const char *func) const {
+        auto name = findKeyByAlias(key);
+        if(name.empty()){
+            throw std::invalid_argument(std::string(func) + ": " + key + " unknown argument");
+        }
+        const auto &arg = m_argMap.find(name)->second;
+        if(arg->m_positional){
+            throw std::invalid_argument(std::string(func) + ": " + key + " constraints are not applicable to positional arguments");
+        }
+        return arg->m_id;
+    }
+
+    [[nodiscard]] parser_internal::dynamicBitset constraintMask(const std::vector<std::string> &keys, const char *func) const {
+        if(keys.empty()){
+            throw std::invalid_argument(std::string(func) + ": list of arguments cannot be empty");
+        }
+        parser_internal::dynamicBitset mask;
+        for(const auto &k : keys){
+            mask.set(constraintArg(k, func));
+        }
+        return mask;
+    }
+
+    /// Dependency or conflict of 'key' with 'keys'. Argument cannot depend on or conflict with itself (aliases included)
+    void addRelation(constraint::kind type, const std::string &key, const std::vector<std::string> &keys, const char *func) {
+        const auto id = constraintArg(key, func);
+        auto mask = constraintMask(keys, func);
+        if(mask.test(id)){
+            throw std::invalid_argument(std::string(func) + ": " + key + " cannot refer to itself");
+        }
+        m_constraints.push_back({type, id, std::move(mask), false});
+    }
+
+    [[nodiscard]] std::string constraintNames(const parser_internal::dynamicBitset &mask, const std::string &separator) const {
+        std::string res;
+        for(size_t i = 0; i < m_argById.size(); ++i){
+            if(mask.test(i)){
+                res += (res.empty() ? "" : separator) + m_argById[i]->m_name;
+            }
+        }
+        return res;
+    }
+
+    void checkConstraints() const {
+        for(const auto &c : m_constraints){
+            switch(c.type){
+                case constraint::kind::EXCLUSIVE: {
+                    auto count = c.mask.countCommon(m_set_mask);
+                    if(count > 1){
+                        auto first = c.mask.firstCommon(m_set_mask);
+                        auto second = c.mask.firstCommon(m_set_mask, first + 1);
+                        throw parse_error(m_argById[first]->m_name + " and " + m_argById[second]->m_name + " are mutually exclusive");
+                    }
+                    if(count == 0 && c.required){
+                        throw parse_error("one of " + constraintNames(c.mask, ", ") + " is required");
+                    }
+                    break;
+                }
+                case constraint::kind::DEPENDENCY: {
+                    if(!m_set_mask.test(c.arg)){
+                        break;
+                    }
+                    auto missing = c.mask.firstNotIn(m_set_mask);
+                    if(missing != parser_internal::dynamicBitset::npos){
+                        throw parse_error(m_argById[c.arg]->m_name + " requires " + m_argById[missing]->m_name);
+                    }
+                    break;
+                }
+                case constraint::kind::CONFLICT: {
+                    if(!m_set_mask.test(c.arg)){
+                        break;
+                    }
+                    auto conflict = c.mask.firstCommon(m_set_mask);
+                    if(conflict != parser_internal::dynamicBitset::npos){
+                        throw parse_error(m_argById[c.arg]->m_name + " conflicts with " + m_argById[conflict]->m_name);
+                    }
+                    break;
+                }
+            }
         }
     }
 
@@ -1474,20 +3401,19 @@ protected:
         if(!m_mandatory_option){
             return;
         }
-        if(m_parsed_mnd_args != m_mandatory_args){
-            for(const auto &arg : m_argMap){
-                if(!arg.second->m_optional && !arg.second->m_positional && !arg.second->m_set){
-                    throw parse_error(arg.first + " not specified");
-                }
-            }
+        auto missing = m_mandatory_mask.firstNotIn(m_set_mask);
+        if(missing != parser_internal::dynamicBitset::npos){
+            throw parse_error(m_argById[missing]->m_name + " not specified");
         }
-        if(m_required_args > 0 && m_parsed_required_args < 1){
+        if(m_required_mask.any() && !m_required_mask.intersects(m_set_mask)){
             throw parse_error(m_binary_name + ": missing required option (*)");
         }
     }
 
     void checkTypos(const std::string& pName) {
+        ARGPARSER_PHASE_BEGIN(timer, TYPOS, pName);
         auto candidate = closestKey(pName);
+        ARGPARSER_PHASE_END(timer, 1, 0);
         if(!candidate.empty() && candidate != pName){
             const auto &arg = m_argMap.find(candidate);
             if (arg != m_argMap.end()) {
@@ -1502,29 +3428,233 @@ protected:
         }
     }
 
-    void setParseCounters() {
-        //count mandatory/required arguments
-        for(const auto &x : m_argMap){
-            if(!x.second->m_optional
-               && !x.second->m_positional){
-                m_mandatory_args++;
-            }else if(x.second->m_optional
-                     && x.second->m_required){
-                m_required_args++;
+    /// Wait for all parallel actions, then throw error of the first failed one (in command line order)
+    void joinParallelActions() {
+        std::unique_ptr<unparsed_param> error;
+        for(auto &x : m_parallel){
+            try{
+                x.result.get();
+            }catch(std::exception &e){
+                if(!error){
+                    error = std::make_unique<unparsed_param>(x.key, e.what(), std::vector<std::string>{m_argVec.begin() + x.start, m_argVec.begin() + x.end});
+                }
+            }catch(...){
+                if(!error){
+                    error = std::make_unique<unparsed_param>(x.key, "unknown error", std::vector<std::string>{m_argVec.begin() + x.start, m_argVec.begin() + x.end});
+                }
+            }
+        }
+        m_parallel.clear();
+        m_parallel_waited = 0;
+        if(error){
+            throw *error;
+        }
+    }
+
+    /// Wait for the thread of the last parseArgsAwaitable(). The thread itself (resumed coroutine) can't wait for itself
+    void joinWorker() {
+        if(m_worker.joinable()){
+            if(m_worker.get_id() == std::this_thread::get_id()){
+                m_worker.detach();
+            }else{
+                m_worker.join();
+            }
+        }
+    }
+
+    void repeatedParseCheck(const char *func) const {
+        if(m_args_parsed){
+            throw parse_error("Repeated attempt to run " + std::string(func));
+        }
+    }
+
+    void prepareParse(size_t tokens, const char *func){
+        repeatedParseCheck(func);
+        checkTokensLimit(tokens);
+        // values set by bootstrap pass are parsed again
+        if(m_bootstrapped){
+            resetParseState();
+            m_bootstrapped = false;
+        }
+    }
+
+    void prepareParse(int argc, char *argv[], const char *func){
+        prepareParse(argc > 0 ? argc - 1 : 0, func);
+        ///Retrieve binary self-name
+        if(m_binary_name.empty()){
+            std::string self_name = std::string(argv[0]);
+            size_t pos = self_name.find_last_of("/\\"); // Handles both Windows and UNIX
+            m_binary_name = (pos == std::string::npos) ? self_name : self_name.substr(pos + 1);
+        }
+        checkArgvBytes(argc, argv);
+    }
+
+    int parseAndReport(std::vector<std::string> &&args){
+        try{
+            return parseArgs(std::move(args));
+        }catch(const parse_error &e){
+            std::cout << e.what() << std::endl;
+            std::cout << "Try '" << help_key << "' for more information" << std::endl;
+            throw;
+        }
+    }
+
+    /// Size of arguments is checked before they are copied
+    void checkArgvBytes(int argc, char *argv[]) const {
+        if(!m_limits.max_bytes){
+            return;
+        }
+        size_t bytes = 0;
+        for(int i = 1; i < argc; ++i){
+            bytes += strlen(argv[i]);
+            checkBytesLimit(bytes);
+        }
+    }
+
+    void checkBytesLimit(size_t bytes) const {
+        if(m_limits.max_bytes && bytes > m_limits.max_bytes){
+            throw limit_error(limit_error::limit::BYTES, m_limits.max_bytes,
+                              m_binary_name + ": size of arguments exceeds limit of " + std::to_string(m_limits.max_bytes) + " bytes");
+        }
+    }
+
+    void checkTokensLimit(size_t tokens) const {
+        if(m_limits.max_tokens && tokens > m_limits.max_tokens){
+            throw limit_error(limit_error::limit::TOKENS, m_limits.max_tokens,
+                              m_binary_name + ": number of arguments exceeds limit of " + std::to_string(m_limits.max_tokens));
+        }
+    }
+
+    /// Replace '@file' tokens in m_argVec with file contents (top level parser only, commands get expanded tokens)
+    void expandResponseFiles() {
+        if(!m_response_files || m_depth != 0){
+            return;
+        }
+        auto isResponseFile = [](const std::string &x){
+            return x.size() > 1 && x.front() == '@';
+        };
+        if(std::none_of(m_argVec.begin(), m_argVec.end(), isResponseFile)){
+            return;
+        }
+        std::vector<std::string> result;
+        std::vector<int> origins;
+        result.reserve(m_argVec.size());
+        // file contents count towards size of arguments
+        m_input_bytes = 0;
+        for(const auto &x : m_argVec){
+            m_input_bytes += x.size();
+        }
+        for(size_t i = 0; i < m_argVec.size(); ++i){
+            expandResponseFile(std::move(m_argVec[i]), result, origins, m_pass_through ? m_arg_origin[i] : 0, 0);
+        }
+        m_argVec = std::move(result);
+        if(m_pass_through != nullptr){
+            m_arg_origin = std::move(origins);
+        }
+    }
+
+    void expandResponseFile(std::string &&token, std::vector<std::string> &result, std::vector<int> &origins,
+                            int origin, size_t depth) {
+        auto keep = [&](){
+            result.push_back(std::move(token));
+            if(m_pass_through != nullptr){
+                origins.push_back(origin);
+            }
+        };
+        if(token.size() < 2 || token.front() != '@'){
+            return keep();
+        }
+        // tokens are copied to m_argVec anyway, so plain read is enough (stops right after the limit)
+        std::string contents;
+        if(!parser_internal::readFile(token.c_str() + 1, contents, m_limits.max_bytes)){
+            return keep();
+        }
+        if(depth >= m_response_depth){
+            throw parse_error(token + ": response files nested deeper than " + std::to_string(m_response_depth));
+        }
+        m_input_bytes += contents.size();
+        checkBytesLimit(m_input_bytes);
+        std::deque<std::string> unescaped;
+        std::vector<std::string_view> tokens;
+        try{
+            tokens = splitCommandLine(contents, unescaped);
+        }catch(const parse_error &e){
+            throw parse_error(token + ": " + e.what());
+        }
+        for(const auto &x : tokens){
+            checkTokensLimit(result.size() + 1);
+            int token_origin = 0;
+            if(m_pass_through != nullptr){
+                // keep original token in case it's passed through
+                m_pass_through->expanded.emplace_back(x);
+                token_origin = -int(m_pass_through->expanded.size());
             }
-            if(x.second->m_hidden){
-                m_hidden_args++;
+            expandResponseFile(std::string(x), result, origins, token_origin, depth + 1);
+        }
+    }
+
+    /// Cut off '--' and arguments after it, they are passed through as is (top level parser only)
+    void splitPassThroughTail() {
+        if(m_pass_through == nullptr || m_depth != 0){
+            return;
+        }
+        const auto end = size_t(std::find(m_argVec.begin(), m_argVec.end(), "--") - m_argVec.begin());
+        for(auto i = end + 1; i < m_argVec.size(); ++i){
+            m_pass_through->tail.push_back(m_pass_through->token(m_arg_origin[i]));
+        }
+        m_argVec.resize(end);
+        m_arg_origin.resize(end);
+    }
+
+    /// Check if unknown token at index should be passed through rather than parsed as positional or command
+    [[nodiscard]] bool shouldPassThrough(int index, const std::vector<bool> &passed) const {
+        // parts of passed through token (e.g. value after '=') follow it
+        if(index > 0 && passed[index - 1] && m_arg_origin[index - 1] == m_arg_origin[index]){
+            return true;
+        }
+        const auto &token = m_argVec[index];
+        if(findChildByName(token) != nullptr){
+            return false;
+        }
+        const bool option_like = token.size() > 1 && token[0] == '-' && !std::isdigit(static_cast<unsigned char>(token[1]));
+        return option_like || positionalsParsed();
+    }
+
+    void passThrough(int index, std::vector<bool> &passed) {
+        passed[index] = true;
+        const auto origin = m_arg_origin[index];
+        // token split while preprocessing is passed once
+        if(origin != m_pass_through->last_origin){
+            m_pass_through->args.push_back(m_pass_through->token(origin));
+            m_pass_through->last_origin = origin;
+        }
+    }
+
+    /// Passed through token cannot be partially parsed (e.g. unknown flag combined with known one)
+    void checkPassedThrough(const std::vector<bool> &passed) const {
+        for(size_t i = 1; i < passed.size(); ++i){
+            if(passed[i] != passed[i - 1] && m_arg_origin[i] == m_arg_origin[i - 1]){
+                throw parse_error(std::string(m_pass_through->token(m_arg_origin[i])) + ": unknown argument");
             }
         }
-        for(const auto &x : m_posMap){
-            const auto &arg = m_argMap.at(x);
-            m_unparsed_mandatory_positionals += arg->m_mandatory_options;
+    }
+
+    void setParseCounters() {
+        for(const auto *arg : m_argById){
+            if(arg->m_positional){
+                m_unparsed_mandatory_positionals += arg->m_mandatory_options;
+            }
         }
 
-        m_mandatory_option = m_mandatory_args || m_required_args;
+        m_mandatory_option = m_mandatory_mask.any() || m_required_mask.any();
     }
 
     int parseSingleArgument(const std::string &key, int start, int end) {
+        if(m_limits.max_values && size_t(end - start) > m_limits.max_values){
+            throw limit_error(limit_error::limit::VALUES, m_limits.max_values,
+                              key + ": " + std::to_string(end - start) + " values exceed limit of " + std::to_string(m_limits.max_values));
+        }
+        ARGPARSER_PHASE_BEGIN(timer, ARGUMENT, key);
         try{
             // remove \0 added while preparing
             for(int i = start; i < end && i < m_argVec.size(); ++i){
@@ -1534,41 +3664,83 @@ protected:
             }
             const std::string *ptr = start < m_argVec.size() ? &m_argVec.at(start) : nullptr;
             auto &arg = m_argMap[key];
-            arg->m_arg_handle->action(ptr, end - start);
+            if(m_parallel_actions && arg->m_parallel){
+                auto handle = arg->m_arg_handle.get();
+                auto size = end - start;
+                if(m_parallel.size() - m_parallel_waited >= m_max_parallel){
+                    // errors stay in the future, they are reported in command line order by joinParallelActions()
+                    m_parallel[m_parallel_waited++].result.wait();
+                }
+                m_parallel.push_back({key, start, end, std::async(std::launch::async, [handle, ptr, size]{
+                    handle->action(ptr, size);
+                })});
+            }else{
+                arg->m_arg_handle->action(ptr, end - start);
+            }
         }catch(std::exception &e){
             throw unparsed_param(key, e.what(), {m_argVec.begin() + start, m_argVec.begin() + end});
         }catch(...){
             throw unparsed_param(key, "unknown error", {m_argVec.begin() + start, m_argVec.begin() + end});
         }
+        ARGPARSER_PHASE_END(timer, end - start, 1);
         return end-start;
     }
 
     int parseArgs(std::vector<std::string> &&arg_vec) {
+        ARGPARSER_PHASE_BEGIN(parse_timer, PARSE, m_binary_name);
         m_argVec = std::move(arg_vec);
+        if(m_pass_through != nullptr && m_depth == 0){
+            m_arg_origin.resize(m_argVec.size());
+            for(size_t i = 0; i < m_arg_origin.size(); ++i){
+                m_arg_origin[i] = int(i);
+            }
+        }
+        expandResponseFiles();
+        splitPassThroughTail();
+        if(m_allow_abbrev){
+            buildAbbrevIndex();
+        }
+        checkTokensLimit(m_argVec.size());
         setParseCounters();
         /// Preprocess argVec (handle '=', aliases, combined args, etc)
+        ARGPARSER_PHASE_BEGIN(preprocess_timer, PREPROCESS, m_binary_name);
         parsePreprocessArgVec();
+        m_next_arg = -1;
+        ARGPARSER_PHASE_END(preprocess_timer, m_argVec.size(), 0);
         /// Main parser loop
+        struct parallelGuard{
+            std::vector<parallelAction> &actions;
+            // if parsing fails, wait for background actions (futures of std::async block in destructor)
+            ~parallelGuard(){ actions.clear(); }
+        } parallel_guard{m_parallel};
+        m_parallel_waited = 0;
         int index = 0;
+        // tokens passed through by parseKnownArgs
+        std::vector<bool> passed(m_pass_through != nullptr ? m_argVec.size() : 0);
         while(index < m_argVec.size()){
             const auto &pName = m_argVec[index];
-            const auto &pValue = index+1 >= m_argVec.size() ? "" : m_argVec[index + 1];
             ///If found unknown key
             if(m_argMap.find(pName) == m_argMap.end()){
+                if(m_pass_through != nullptr && shouldPassThrough(index, passed)){
+                    passThrough(index++, passed);
+                    continue;
+                }
                 ///Check if it's an arg with a typo
-                checkTypos(pName);
+                if(m_pass_through == nullptr){
+                    checkTypos(pName);
+                }
                 /// Handle positional args and child parsers
                 const auto before_pos = index;
                 index = parseHandleChildAndPositional(before_pos);
                 /// If we just parsed all positional args, continue
-                if (index - before_pos > 0 && positionalsParsed()){
+                if (index - before_pos > 0 && (positionalsParsed() || m_pass_through != nullptr)){
                     continue;
                 }
                 break;
             }
             ///Show help
             else if(pName == help_key){
-                printHelp(pValue);
+                printHelp(size_t(index + 1) >= m_argVec.size() ? "" : m_argVec[index + 1]);
                 exit(0);
             }
             else{
@@ -1577,8 +3749,13 @@ protected:
                 setArgument(pName);
             }
         }
+        joinParallelActions();
+        if(m_pass_through != nullptr){
+            checkPassedThrough(passed);
+        }
 
         checkParsedNonPos();
+        checkConstraints();
         if(index < m_argVec.size()){
             throw parse_error(m_argVec[index] + ": unknown argument");
         }
@@ -1589,11 +3766,157 @@ protected:
             throw parse_error(m_binary_name + ": no command provided");
         }
 
+        if(m_reloading){
+            checkImmutable();
+            for(const auto *arg : m_argById){
+                arg->m_arg_handle->publish_global();
+            }
+        }
         m_args_parsed = true;
+        if(m_live){
+            publishValues();
+        }
+        ARGPARSER_PHASE_BEGIN(callback_timer, CALLBACK, m_binary_name);
         m_callback(); //run callback
+        ARGPARSER_PHASE_END(callback_timer, 0, 0);
+        ARGPARSER_PHASE_END(parse_timer, m_argVec.size(), 0);
         return index;
     }
 
+    void publishValues() {
+        auto published = std::make_unique<Values>();
+        const auto previous = m_values.load(std::memory_order_relaxed);
+        published->m_version = previous == nullptr ? 1 : previous->m_version + 1;
+        for(const auto *arg : m_argById){
+            if(arg->m_name == help_key){
+                continue;
+            }
+            auto &entry = published->m_entries[arg->m_name];
+            entry.set = arg->m_set;
+            // default provider isn't run by publishing, only by a reader
+            if(auto pending = arg->m_arg_handle->pending_default()){
+                entry.deferred = std::make_shared<Values::deferredValue>();
+                entry.deferred->compute = std::move(pending);
+            }else{
+                entry.value = arg->m_arg_handle->get_any_val();
+            }
+            for(const auto &alias : arg->m_aliases){
+                published->m_aliases[alias] = arg->m_name;
+            }
+        }
+        m_values.store(published.get());
+        if(m_published){
+            m_retired[m_epoch.load(std::memory_order_relaxed) & 1].push_back(std::move(m_published));
+        }
+        m_published = std::move(published);
+        reclaimValues();
+    }
+
+    /// Free values retired in previous epoch if none of its readers is left and start a new epoch. Never waits for readers
+    void reclaimValues() {
+        const auto epoch = m_epoch.load(std::memory_order_relaxed);
+        const auto previous = (epoch + 1) & 1;
+        // readers which registered after epoch changed can only see values published after it
+        if(m_readers[previous].load() != 0){
+            return;
+        }
+        m_retired[previous].clear();
+        m_epoch.store(epoch + 1);
+    }
+
+    void checkLiveArgument(const Argument &arg, const char *func) const {
+        if(arg.m_arg_handle->has_plain_global()){
+            throw std::logic_error(std::string(func) + ": " + arg.m_name + " live reload requires std::atomic global pointer and no appendTo container");
+        }
+        // publishing reads every value, it would run deferred callable right after parsing
+        if(arg.m_lazy){
+            throw std::logic_error(std::string(func) + ": " + arg.m_name + " lazy argument cannot be used with live reload");
+        }
+    }
+
+    void checkImmutable() const {
+        const auto snapshot = values();
+        const auto &previous = *snapshot;
+        for(const auto *arg : m_argById){
+            if(!arg->m_immutable){
+                continue;
+            }
+            const auto &entry = previous.m_entries.at(arg->m_name);
+            // both unset with default provider pending are the same
+            const bool same = entry.deferred ? arg->m_arg_handle->pending_default() != nullptr
+                                             : arg->m_arg_handle->same_value(entry.value);
+            if(arg->m_set != entry.set || !same){
+                throw parse_error(arg->m_name + ": cannot be changed at runtime");
+            }
+        }
+    }
+
+    // bring parser back to the state before parsing
+    void resetParseState() {
+        m_args_parsed = false;
+        m_typo_work = 0;
+        m_mandatory_option = false;
+        m_command_parsed = false;
+        m_positional_args_parsed = 0;
+        m_unparsed_mandatory_positionals = 0;
+        m_command_offset = 0;
+        m_set_mask.reset();
+        for(auto *arg : m_argById){
+            arg->m_set = false;
+            arg->m_arg_handle->reset();
+        }
+        m_bootstrap_values.clear();
+    }
+
+    int reload(std::vector<std::string> &&arg_vec) {
+        if(!m_live){
+            throw std::logic_error(std::string(__func__) + ": Invalid call. liveReload() not enabled");
+        }
+        if(hasCommands()){
+            throw std::logic_error(std::string(__func__) + ": Invalid call. Commands cannot be reloaded");
+        }
+        parsedCheck(__func__);
+        // published const char* values may point to current args, they are freed with the values
+        // (if last reload failed, values still point to args already kept)
+        if(m_published && m_published->m_args.empty()){
+            m_published->m_args = std::move(m_argVec);
+        }
+        resetParseState();
+        for(const auto *arg : m_argById){
+            arg->m_arg_handle->hold_global(true);
+        }
+        m_reloading = true;
+        try{
+            auto index = parseArgs(std::move(arg_vec));
+            m_reloading = false;
+            for(const auto *arg : m_argById){
+                arg->m_arg_handle->hold_global(false);
+            }
+            return index;
+        }catch(...){
+            // roll back to the last published values
+            const auto snapshot = values();
+            const auto &previous = *snapshot;
+            for(auto *arg : m_argById){
+                arg->m_arg_handle->hold_global(false);
+                auto entry = previous.m_entries.find(arg->m_name);
+                if(entry != previous.m_entries.end()){
+                    arg->m_set = entry->second.set;
+                    m_set_mask.set(arg->m_id, entry->second.set);
+                    if(entry->second.deferred){
+                        // default provider was pending
+                        arg->m_arg_handle->reset();
+                    }else{
+                        arg->m_arg_handle->restore(entry->second.value);
+                    }
+                }
+            }
+            m_reloading = false;
+            m_args_parsed = true;
+            throw;
+        }
+    }
+
     static std::string formatChoices(const std::unique_ptr<Argument> &arg) {
         const auto &choices = arg->m_arg_handle->get_str_choices();
         if (choices.empty()){
@@ -1617,13 +3940,44 @@ protected:
         return aliases;
     }
 
-    static std::string formatVariadic(const std::string &opt) {
-        return "[" + opt + "]...";
+    // nargs range, wide ones are shown as count instead of listing every option
+    static std::string formatNargs(const std::unique_ptr<Argument> &arg, const std::string &mandatory, const std::string &optional) {
+        static constexpr size_t max_listed = 4;
+        const auto min = size_t(arg->m_mandatory_options);
+        const auto max = arg->m_options_count;
+        std::string result;
+        if(max <= max_listed){
+            for(size_t i = 0; i < max; ++i){
+                result += " " + (i < min ? mandatory : optional);
+            }
+            if(arg->isVariadic()){
+                result += " " + optional + "...";
+            }
+            return result;
+        }
+        const bool open_range = max > min || arg->isVariadic();
+        if(min > 0){
+            result += " " + mandatory + (open_range ? "" : "...");
+        }
+        if(open_range){
+            result += " " + optional + "...";
+        }
+        result += "{" + std::to_string(min);
+        if(arg->isVariadic()){
+            result += "..";
+        }else if(max > min){
+            result += ".." + std::to_string(max);
+        }
+        return result + "}";
     }
 
     static std::string formatOptions(const std::unique_ptr<Argument> &arg) {
         std::string result;
         std::string choices_str = formatChoices(arg);
+        if(arg->m_options.empty()){
+            const auto opt = !choices_str.empty() ? std::string_view(choices_str) : arg->m_nargs_var;
+            return formatNargs(arg, "<" + std::string(opt) + ">", "[" + std::string(opt) + "]");
+        }
         for(const auto &option : arg->m_options) {
             auto formatted = [&choices_str, &option](){
                 bool is_mandatory = parser_internal::isOptMandatory(option);
@@ -1636,9 +3990,6 @@ protected:
                 result += " " + formatted;
             }
         }
-        if (arg->isVariadic()) {
-            result += " " + formatVariadic(!choices_str.empty() ? choices_str : arg->m_nargs_var);
-        }
         return result;
     }
 
@@ -1651,15 +4002,16 @@ protected:
         std::string usage;
         for(const auto &posArg : m_posMap){
             const auto &details = m_argMap.at(posArg);
-            std::string opt = details->m_nargs_var.empty() ? posArg : details->m_nargs_var;
+            std::string opt = details->m_nargs_var.empty() ? posArg : std::string(details->m_nargs_var);
+            if(details->m_options.empty()){
+                usage += formatNargs(details, opt, "[" + opt + "]");
+                continue;
+            }
             for(const auto &option : details->m_options){
                 std::string tmp = opt;
                 tmp = !parser_internal::isOptMandatory(option) ? ("[" + tmp + "]") : tmp;
                 usage += " " + tmp;
             }
-            if(details->isVariadic()){
-                usage += " " + formatVariadic(opt);
-            }
         }
         return usage;
     }
@@ -1771,10 +4123,12 @@ protected:
 
             printParamDetails(it);
 
-            std::string default_str = arg->m_show_default ? arg->m_arg_handle->get_str_val() : "";
+            std::string default_str = !arg->m_default_placeholder.empty()
+                    ? std::string(arg->m_default_placeholder)
+                    : (arg->m_show_default ? arg->m_arg_handle->get_str_val() : "");
             default_str = !default_str.empty() ? " (default " + default_str + ")" : "";
             std::string repeatable_str = arg->m_repeatable ? " [repeatable]" : "";
-            std::string required_str = arg->m_required ? (m_required_args > 1 ? " (*)" : "") : "";
+            std::string required_str = arg->m_required ? (m_required_mask.count() > 1 ? " (*)" : "") : "";
 
             std::cout << " : ";
             std::cout << arg->m_help;
@@ -1809,14 +4163,12 @@ protected:
     }
 
     [[nodiscard]] bool hasFlags() const {
-        return std::any_of(m_argMap.begin(), m_argMap.end(), [](const auto &p) {
-            return p.second->m_optional && !p.second->m_required;
+        return std::any_of(m_argById.begin(), m_argById.end(), [](const Argument *arg) {
+            return arg->m_optional && !arg->m_required;
         });
     }
     [[nodiscard]] bool hasMandatoryParameters() const {
-        return std::any_of(m_argMap.begin(), m_argMap.end(), [](const auto &p) {
-            return !p.second->m_positional && (!p.second->m_optional || p.second->m_required);
-        });
+        return m_mandatory_mask.any() || m_required_mask.any();
     }
     [[nodiscard]] bool hasCommands() const {
         return !m_commandMap.empty();
@@ -1831,7 +4183,7 @@ protected:
         } else {
             printHelpCommon(/*advanced=*/false);
         }
-        if(m_required_args > 1){
+        if(m_required_mask.count() > 1){
             std::cout << "For options marked with (*): at least one such option should be provided" << std::endl;
         }
     }
@@ -0,0 +1,418 @@
+#include <chrono>
+#include <fstream>
+#include <new>
+#include <cstdlib>
+#include <cstddef>
+#include "argparser.hpp"
+
+/**
+ *  Microbenchmarks
+ *
+ *  Every case builds a synthetic spec of N options, runs the measured operation
+ *  until --min-time is spent (at least 3 times), and prints one JSON object per case:
+ *  {"name": ..., "n": N, "runs": ..., "ns_median": ..., "ns_min": ..., "ns_per_item": ..., "allocs": ..., "bytes": ...,
+ *   "retained_per_item": ...}
+ *
+ *  allocs and bytes are per run, counted by the global operator new below.
+ *  retained_per_item is memory still allocated after the run divided by N (for 'register' it's memory per option)
+ *  Cases processing text also print "mb_per_s", input size divided by median time
+ */
+
+static std::atomic<size_t> g_allocations{0};
+static std::atomic<size_t> g_allocated_bytes{0};
+static std::atomic<size_t> g_live_bytes{0};
+
+// size is stored in front of every block to track live memory
+static constexpr size_t header_size = alignof(std::max_align_t);
+
+void *operator new(std::size_t size){
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    g_live_bytes.fetch_add(size, std::memory_order_relaxed);
+    if(auto *p = static_cast<char*>(std::malloc(size + header_size))){
+        *reinterpret_cast<std::size_t*>(p) = size;
+        return p + header_size;
+    }
+    throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept{
+    if(!p){
+        return;
+    }
+    auto *block = static_cast<char*>(p) - header_size;
+    g_live_bytes.fetch_sub(*reinterpret_cast<std::size_t*>(block), std::memory_order_relaxed);
+    std::free(block);
+}
+void operator delete(void *p, std::size_t) noexcept{
+    operator delete(p);
+}
+
+// exposes help rendering
+class benchParser : public argParser {
+public:
+    using argParser::argParser;
+    void printHelp() {
+        argParser::printHelpCommon(false);
+    }
+};
+
+// owns tokens and argv pointing to them
+struct commandLine{
+    std::vector<std::string> tokens;
+    std::vector<char*> argv;
+
+    explicit commandLine(std::vector<std::string> &&args) : tokens(std::move(args)) {
+        tokens.insert(tokens.begin(), "bench");
+        for(auto &t : tokens){
+            argv.push_back(&t[0]);
+        }
+    }
+    int argc() const {return int(argv.size());}
+    char **data() {return argv.data();}
+};
+
+struct result{
+    std::string name;
+    size_t n = 0;
+    size_t runs = 0;
+    double ns_median = 0;
+    double ns_min = 0;
+    size_t allocs = 0;
+    size_t bytes = 0;
+    long long retained = 0;
+    size_t input_bytes = 0;
+};
+
+class benchmark{
+public:
+    explicit benchmark(std::chrono::milliseconds min_time, std::string filter)
+            : m_min_time(min_time), m_filter(std::move(filter)) {}
+
+    // setup() prepares state of a single run (not measured), run(state) is measured
+    // input_bytes is the size of text processed by a run, if any
+    template<typename Setup, typename Run>
+    void measure(const std::string &name, size_t n, Setup &&setup, Run &&run, size_t input_bytes = 0) {
+        if(!m_filter.empty() && name.find(m_filter) == std::string::npos){
+            return;
+        }
+        using clock = std::chrono::steady_clock;
+        std::vector<double> samples;
+        size_t allocs = 0;
+        size_t bytes = 0;
+        long long retained = 0;
+        clock::duration total{};
+        while(samples.size() < 3 || (total < m_min_time && samples.size() < 10000)){
+            auto state = setup();
+            auto allocs_before = g_allocations.load(std::memory_order_relaxed);
+            auto bytes_before = g_allocated_bytes.load(std::memory_order_relaxed);
+            auto live_before = g_live_bytes.load(std::memory_order_relaxed);
+            auto start = clock::now();
+            run(state);
+            auto elapsed = clock::now() - start;
+            allocs = g_allocations.load(std::memory_order_relaxed) - allocs_before;
+            bytes = g_allocated_bytes.load(std::memory_order_relaxed) - bytes_before;
+            retained = (long long)g_live_bytes.load(std::memory_order_relaxed) - (long long)live_before;
+            total += elapsed;
+            samples.push_back(double(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        }
+        std::sort(samples.begin(), samples.end());
+        m_results.push_back({name, n, samples.size(), samples[samples.size() / 2], samples.front(), allocs, bytes, retained, input_bytes});
+    }
+
+    void print(std::ostream &out) const {
+        for(const auto &r : m_results){
+            out << "{\"name\": \"" << r.name << "\""
+                << ", \"n\": " << r.n
+                << ", \"runs\": " << r.runs
+                << ", \"ns_median\": " << std::fixed << std::setprecision(0) << r.ns_median
+                << ", \"ns_min\": " << r.ns_min
+                << ", \"ns_per_item\": " << std::setprecision(2) << r.ns_median / double(std::max<size_t>(r.n, 1))
+                << ", \"allocs\": " << r.allocs
+                << ", \"bytes\": " << r.bytes
+                << ", \"retained_per_item\": " << std::setprecision(1) << double(r.retained) / double(std::max<size_t>(r.n, 1));
+            if(r.input_bytes){
+                // bytes per ns * 1000 = MB/s
+                out << ", \"mb_per_s\": " << std::setprecision(1) << double(r.input_bytes) * 1000.0 / std::max(r.ns_median, 1.0);
+            }
+            out << "}" << std::endl;
+        }
+    }
+
+private:
+    std::chrono::milliseconds m_min_time;
+    std::string m_filter;
+    std::vector<result> m_results;
+};
+
+// synthetic spec: N int options "--opt-<i>" with a single parameter
+void addIntOptions(argParser &parser, size_t n){
+    for(size_t i = 0; i < n; ++i){
+        auto key = "--opt-" + std::to_string(i);
+        parser.addArgument<int>(key.c_str())
+                .parameters("int")
+                .help("synthetic int option")
+                .finalize();
+    }
+}
+
+// synthetic spec: N implicit flags "--flag-<i>"
+void addFlags(argParser &parser, size_t n){
+    for(size_t i = 0; i < n; ++i){
+        auto key = "--flag-" + std::to_string(i);
+        parser.addArgument<bool>(key.c_str())
+                .help("synthetic flag")
+                .finalize();
+    }
+}
+
+std::unique_ptr<benchParser> makeParser(){
+    return std::make_unique<benchParser>("bench", "");
+}
+
+void runAll(benchmark &bench, size_t n){
+    // registration
+    bench.measure("register", n,
+                  []{return makeParser();},
+                  [n](auto &p){addIntOptions(*p, n);});
+
+    // separate tokens: --opt-i i
+    bench.measure("parse_separate", n,
+                  [n]{
+                      auto p = makeParser();
+                      addIntOptions(*p, n);
+                      std::vector<std::string> args;
+                      for(size_t i = 0; i < n; ++i){
+                          args.push_back("--opt-" + std::to_string(i));
+                          args.push_back(std::to_string(i));
+                      }
+                      return std::make_pair(std::move(p), commandLine(std::move(args)));
+                  },
+                  [](auto &s){s.first->parseArgs(s.second.argc(), s.second.data());});
+
+    // '=' form: --opt-i=i
+    bench.measure("parse_equals", n,
+                  [n]{
+                      auto p = makeParser();
+                      addIntOptions(*p, n);
+                      std::vector<std::string> args;
+                      for(size_t i = 0; i < n; ++i){
+                          args.push_back("--opt-" + std::to_string(i) + "=" + std::to_string(i));
+                      }
+                      return std::make_pair(std::move(p), commandLine(std::move(args)));
+                  },
+                  [](auto &s){s.first->parseArgs(s.second.argc(), s.second.data());});
+
+    // implicit flags
+    bench.measure("parse_flags", n,
+                  [n]{
+                      auto p = makeParser();
+                      addFlags(*p, n);
+                      std::vector<std::string> args;
+                      for(size_t i = 0; i < n; ++i){
+                          args.push_back("--flag-" + std::to_string(i));
+                      }
+                      return std::make_pair(std::move(p), commandLine(std::move(args)));
+                  },
+                  [](auto &s){s.first->parseArgs(s.second.argc(), s.second.data());});
+
+    // combined short flags: n flags as -ABC...Z clusters
+    bench.measure("parse_combined", n,
+                  [n]{
+                      auto p = makeParser();
+                      for(char c = 'A'; c <= 'Z'; ++c){
+                          const std::string key = {'-', c};
+                          p->addArgument<int>(key.c_str()).repeatable().finalize();
+                      }
+                      std::vector<std::string> args;
+                      for(size_t i = 0; i < n; i += 26){
+                          args.emplace_back("-ABCDEFGHIJKLMNOPQRSTUVWXYZ");
+                      }
+                      return std::make_pair(std::move(p), commandLine(std::move(args)));
+                  },
+                  [](auto &s){s.first->parseArgs(s.second.argc(), s.second.data());});
+
+    // variadic with n values
+    bench.measure("parse_variadic", n,
+                  [n]{
+                      auto p = makeParser();
+                      p->addArgument<int>("--values").nargs<0, -1>().finalize();
+                      std::vector<std::string> args = {"--values"};
+                      for(size_t i = 0; i < n; ++i){
+                          args.push_back(std::to_string(i));
+                      }
+                      return std::make_pair(std::move(p), commandLine(std::move(args)));
+                  },
+                  [](auto &s){s.first->parseArgs(s.second.argc(), s.second.data());});
+
+    // n options of a command nested 8 levels deep
+    bench.measure("parse_commands", n,
+                  [n]{
+                      auto p = makeParser();
+                      argParser *cmd = p.get();
+                      std::vector<std::string> args;
+                      for(int depth = 0; depth < 8; ++depth){
+                          auto name = "cmd" + std::to_string(depth);
+                          cmd = &cmd->addCommand(name, "nested command");
+                          args.push_back(name);
+                      }
+                      addIntOptions(*cmd, n);
+                      for(size_t i = 0; i < n; ++i){
+                          args.push_back("--opt-" + std::to_string(i));
+                          args.push_back(std::to_string(i));
+                      }
+                      return std::make_pair(std::move(p), commandLine(std::move(args)));
+                  },
+                  [](auto &s){s.first->parseArgs(s.second.argc(), s.second.data());});
+
+    // typo detection against n options
+    bench.measure("typo_detection", n,
+                  [n]{
+                      auto p = makeParser();
+                      addIntOptions(*p, n);
+                      return std::make_pair(std::move(p), commandLine({"--otp-0", "1"}));
+                  },
+                  [](auto &s){
+                      try{
+                          s.first->parseArgs(s.second.argc(), s.second.data());
+                      }catch(const argParser::parse_error &){}
+                  });
+
+    // command line strings of n options, plain and quoted
+    std::string plain_line;
+    std::string quoted_line;
+    for(size_t i = 0; i < n; ++i){
+        plain_line += "--opt-" + std::to_string(i) + " " + std::to_string(i) + " ";
+        quoted_line += "--opt-" + std::to_string(i) + " '" + std::to_string(i) + "' \"" + std::to_string(i) + "\\\"\" ";
+    }
+    bench.measure("tokenize_plain", n,
+                  []{return std::deque<std::string>();},
+                  [&plain_line](auto &unescaped){argParser::splitCommandLine(plain_line, unescaped);},
+                  plain_line.size());
+    bench.measure("tokenize_quoted", n,
+                  []{return std::deque<std::string>();},
+                  [&quoted_line](auto &unescaped){argParser::splitCommandLine(quoted_line, unescaped);},
+                  quoted_line.size());
+    bench.measure("parse_command_line", n,
+                  [n]{
+                      auto p = makeParser();
+                      addIntOptions(*p, n);
+                      return p;
+                  },
+                  [&plain_line](auto &p){p->parseCommandLine(plain_line);},
+                  plain_line.size());
+
+    // n NUL-separated command lines (e.g. /proc/<pid>/cmdline) parsed with the same spec
+    bench.measure("parse_cmdline_bulk", n,
+                  [n]{
+                      auto p = makeParser();
+                      addIntOptions(*p, 10);
+                      std::vector<std::string> buffers;
+                      for(size_t i = 0; i < n; ++i){
+                          buffers.push_back(std::string("/usr/bin/host\0--host-option\0--opt-", 34) + std::to_string(i % 10)
+                                            + std::string("\0", 1) + std::to_string(i));
+                      }
+                      return std::make_pair(std::move(p), std::move(buffers));
+                  },
+                  [](auto &s){
+                      for(auto &buffer : s.second){
+                          s.first->parseCmdline(std::move(buffer));
+                          s.first->resetParse();
+                      }
+                  });
+
+    // numeric conversion of n values
+    std::vector<std::string> numbers;
+    for(size_t i = 0; i < n; ++i){
+        numbers.push_back(std::to_string(i * 7919));
+    }
+    bench.measure("convert_int", n,
+                  []{return 0;},
+                  [&numbers](auto &sum){
+                      for(const auto &x : numbers){
+                          sum += argParser::scanValue<int>(x.c_str());
+                      }
+                  });
+    bench.measure("convert_double", n,
+                  []{return 0.0;},
+                  [&numbers](auto &sum){
+                      for(const auto &x : numbers){
+                          sum += argParser::scanValue<double>(x.c_str());
+                      }
+                  });
+
+    // help for n options
+    bench.measure("help", n,
+                  [n]{
+                      auto p = makeParser();
+                      addIntOptions(*p, n);
+                      return p;
+                  },
+                  [](auto &p){p->printHelp();});
+
+    // retrieve n values
+    bench.measure("get_value", n,
+                  [n]{
+                      auto p = makeParser();
+                      addIntOptions(*p, n);
+                      commandLine cl({});
+                      p->parseArgs(cl.argc(), cl.data());
+                      std::vector<std::string> keys;
+                      for(size_t i = 0; i < n; ++i){
+                          keys.push_back("--opt-" + std::to_string(i));
+                      }
+                      return std::make_pair(std::move(p), std::move(keys));
+                  },
+                  [](auto &s){
+                      int sum = 0;
+                      for(const auto &k : s.second){
+                          sum += s.first->template getValue<int>(k);
+                      }
+                      if(sum != 0) std::abort();
+                  });
+}
+
+int main(int argc, char *argv[]) {
+    argParser parser("bench", "argparser microbenchmarks");
+    parser.addArgument<int>("-n", "--sizes")
+            .nargs<1, -1>()
+            .help("number of options/tokens per case (default 10 100 1000 5000)")
+            .finalize();
+    parser.addArgument<int>("-t", "--min-time")
+            .parameters("ms")
+            .defaultValue(100)
+            .help("minimal measured time per case, ms")
+            .finalize();
+    parser.addArgument<std::string>("-f", "--filter")
+            .parameters("name")
+            .help("run only cases containing name")
+            .finalize();
+    parser.addArgument<std::string>("-o", "--output")
+            .parameters("file")
+            .help("write results to file instead of stdout")
+            .finalize();
+    parser.parseArgs(argc, argv);
+
+    auto sizes = parser["--sizes"].isSet()
+            ? parser.getValue<std::vector<int>>("--sizes")
+            : std::vector<int>{10, 100, 1000, 5000};
+    benchmark bench(std::chrono::milliseconds(parser.getValue<int>("--min-time")),
+                    parser.getValue<std::string>("--filter"));
+
+    // silence parser output (errors, help) while measuring
+    std::ostringstream sink;
+    auto original = std::cout.rdbuf(sink.rdbuf());
+    for(auto n : sizes){
+        runAll(bench, size_t(std::max(n, 1)));
+        sink.str("");
+    }
+    std::cout.rdbuf(original);
+
+    auto output = parser.getValue<std::string>("--output");
+    if(output.empty()){
+        bench.print(std::cout);
+    }else{
+        std::ofstream file(output);
+        bench.print(file);
+    }
+    return 0;
+}
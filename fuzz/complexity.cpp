@@ -0,0 +1,192 @@
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include "fuzz_input.hpp"
+
+/**
+ *  Scaling check for the parse loop
+ *
+ *  Every family builds a spec and a command line of N tokens (or N chars) designed to hit
+ *  one path of the parser, then it's parsed for growing N. Growth exponent is estimated
+ *  from the two largest sizes, anything above 'max_exponent' is reported as super-linear.
+ *  Random inputs from fuzzInput are checked the same way, repeating their command line.
+ *
+ *  usage: fuzz_complexity [max_n] [random_seeds]
+ *  returns 1 if any super-linear case was found
+ */
+
+static constexpr double max_exponent = 1.4;
+
+struct family{
+    const char *name;
+    void (*spec)(argParser &);
+    std::vector<std::string> (*args)(size_t n);
+};
+
+static std::vector<std::string> repeatToken(const std::string &token, size_t n){
+    return std::vector<std::string>(n, token);
+}
+
+static const family families[] = {
+        {"equals_sign",
+         [](argParser &p){ p.addArgument<int>("-i").parameters("int").repeatable().finalize(); },
+         [](size_t n){ return repeatToken("-i=1", n); }},
+        {"contiguous_value",
+         [](argParser &p){ p.addArgument<int>("-i").parameters("int").repeatable().finalize(); },
+         [](size_t n){ return repeatToken("-i1", n); }},
+        {"combined_flags",
+         [](argParser &p){ p.addArgument<int>("-v").repeatable().finalize(); },
+         [](size_t n){ return std::vector<std::string>{"-" + std::string(n, 'v')}; }},
+        {"combined_flags_with_value",
+         [](argParser &p){
+             p.addArgument<int>("-v").repeatable().finalize();
+             p.addArgument<std::string>("-s").parameters("str").repeatable().finalize();
+         },
+         [](size_t n){ return repeatToken("-vvvs" + std::string(16, 'x'), n); }},
+        {"aliases",
+         [](argParser &p){
+             for(int i = 0; i < 100; ++i){
+                 auto key = "--key" + std::to_string(i);
+                 auto alias = "--alias" + std::to_string(i);
+                 p.addArgument<int>(alias.c_str(), key.c_str()).repeatable().finalize();
+             }
+         },
+         [](size_t n){ return repeatToken("--alias99", n); }},
+        {"variadic",
+         [](argParser &p){ p.addArgument<int>("-l").nargs<0,-1>().finalize(); },
+         [](size_t n){
+             auto args = repeatToken("1", n);
+             args.front() = "-l";
+             return args;
+         }},
+        {"positionals_after_option",
+         [](argParser &p){
+             p.addArgument<int>("-o").nargs<1,3>().finalize();
+             p.addPositional<int>("first").finalize();
+             p.addPositional<std::string>("rest").nargs<1,-1>().finalize();
+         },
+         [](size_t n){
+             auto args = repeatToken("2", n);
+             args.front() = "-o";
+             return args;
+         }},
+        {"repeated_option_before_values",
+         [](argParser &p){
+             p.addArgument<int>("-o").parameters("int").repeatable().finalize();
+             p.addPositional<std::string>("rest").nargs<1,-1>().finalize();
+         },
+         [](size_t n){
+             std::vector<std::string> args;
+             for(size_t i = 0; i < n / 2; ++i){
+                 args.emplace_back("-o");
+                 args.emplace_back("1");
+             }
+             args.emplace_back("value");
+             return args;
+         }},
+        {"unknown_long_token",
+         [](argParser &p){
+             p.addArgument<int>("--option").parameters("int").finalize();
+             p.addPositional<int>("pos").finalize();
+         },
+         [](size_t n){ return std::vector<std::string>{"--" + std::string(n, 'o')}; }},
+        {"command_tail",
+         [](argParser &p){
+             auto &cmd = p.addCommand("cmd", "command");
+             cmd.addArgument<int>("-c").repeatable().finalize();
+         },
+         [](size_t n){
+             auto args = repeatToken("-c", n);
+             args.front() = "cmd";
+             return args;
+         }},
+};
+
+static double seconds(std::chrono::nanoseconds t){
+    return std::chrono::duration<double>(t).count();
+}
+
+template<typename Run>
+static double bestOf3(Run &&run){
+    double best = run();
+    for(int i = 0; i < 2; ++i){
+        best = std::min(best, run());
+    }
+    return best;
+}
+
+static double runFamily(const family &f, size_t n){
+    return bestOf3([&]{
+        argParser parser("complexity");
+        f.spec(parser);
+        auto args = f.args(n);
+        std::vector<char*> argv{const_cast<char*>("complexity")};
+        for(auto &a : args){
+            argv.push_back(&a[0]);
+        }
+        muteOutput mute;
+        auto start = std::chrono::steady_clock::now();
+        try{
+            parser.parseArgs(int(argv.size()), argv.data());
+        }catch(const argParser::parse_error &){
+        }catch(const argParser::unparsed_param &){
+        }
+        return seconds(std::chrono::steady_clock::now() - start);
+    });
+}
+
+static double exponent(double t_small, double t_large, double ratio){
+    return std::log(std::max(t_large, 1e-9) / std::max(t_small, 1e-9)) / std::log(ratio);
+}
+
+int main(int argc, char *argv[]){
+    size_t max_n = argc > 1 ? std::stoul(argv[1]) : 64000;
+    size_t seeds = argc > 2 ? std::stoul(argv[2]) : 200;
+    int failed = 0;
+
+    std::printf("%-32s %10s %12s %10s\n", "family", "n", "ns/token", "exponent");
+    for(const auto &f : families){
+        double prev = 0;
+        size_t prev_n = 0;
+        double exp = 0;
+        for(size_t n = max_n / 16; n <= max_n; n *= 2){
+            auto t = runFamily(f, n);
+            if(prev_n){
+                exp = exponent(prev, t, double(n) / double(prev_n));
+            }
+            std::printf("%-32s %10zu %12.1f %10.2f\n", f.name, n, t * 1e9 / double(n), exp);
+            prev = t;
+            prev_n = n;
+        }
+        if(exp > max_exponent){
+            std::printf("%s: super-linear\n", f.name);
+            ++failed;
+        }
+    }
+
+    // random specs and command lines, repeated 8x and 32x
+    std::mt19937 rng(42);
+    for(size_t seed = 0; seed < seeds; ++seed){
+        std::vector<uint8_t> data(64 + rng() % 192);
+        for(auto &b : data){
+            b = uint8_t(rng());
+        }
+        auto run = [&](size_t repeat){
+            return bestOf3([&]{ return seconds(timedParse(data.data(), data.size(), repeat)); });
+        };
+        auto small = run(64);
+        auto large = run(256);
+        auto exp = exponent(small, large, 4);
+        // short runs are mostly noise
+        if(large > 1e-3 && exp > max_exponent){
+            std::printf("random seed %zu: super-linear (exponent %.2f), input:", seed, exp);
+            for(auto b : data){
+                std::printf(" %02x", b);
+            }
+            std::printf("\n");
+            ++failed;
+        }
+    }
+    std::printf("%zu random inputs checked\n", seeds);
+    return failed ? 1 : 0;
+}
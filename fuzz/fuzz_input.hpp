@@ -0,0 +1,194 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include "argparser.hpp"
+
+/**
+ *  Builds a parser spec and a command line from arbitrary bytes.
+ *
+ *  First byte selects number of options, every option takes 2 bytes (kind, aliases).
+ *  The rest of bytes produce tokens, 2 bytes per token (kind, argument).
+ *  Keys never contain 'h', so generated tokens can't reach help (which exits)
+ */
+class fuzzInput{
+public:
+    fuzzInput(const uint8_t *data, size_t size) : m_data(data), m_size(size) {}
+
+    /// Register options on parser. Invalid combinations are skipped
+    void buildSpec(argParser &parser){
+        size_t count = next() % 16 + 1;
+        for(size_t i = 0; i < count && !done(); ++i){
+            auto kind = next();
+            auto alias = next();
+            try{
+                addOption(parser, i, kind, alias);
+            }catch(const std::invalid_argument &){
+                // e.g. positional after variadic positional, skip
+            }
+        }
+        // parser with commands requires one of them on command line, so only add them by choice
+        if(next() % 4 == 0){
+            auto &cmd = parser.addCommand("cmd", "command");
+            cmd.addArgument<int>("-c").repeatable().finalize();
+            cmd.addPositional<std::string>("cmd_pos").nargs<0,-1>().finalize();
+        }
+    }
+
+    /// Tokens from the rest of input
+    std::vector<std::string> buildArgs(){
+        std::vector<std::string> args;
+        while(!done()){
+            auto kind = next();
+            auto arg = next();
+            args.push_back(token(kind, arg));
+        }
+        return args;
+    }
+
+    static std::string shortKey(size_t i){
+        // skip 'h' (help alias)
+        char c = char('a' + i % 25);
+        return {'-', c >= 'h' ? char(c + 1) : c};
+    }
+    static std::string longKey(size_t i){
+        return "--opt" + std::to_string(i);
+    }
+
+private:
+    const uint8_t *m_data;
+    size_t m_size;
+    size_t m_pos = 0;
+    std::vector<std::string> m_keys;
+
+    [[nodiscard]] bool done() const {
+        return m_pos >= m_size;
+    }
+    uint8_t next(){
+        return done() ? 0 : m_data[m_pos++];
+    }
+
+    void addOption(argParser &parser, size_t i, uint8_t kind, uint8_t alias){
+        auto lkey = longKey(i);
+        auto skey = shortKey(i);
+        const char *key = lkey.c_str();
+        const char *short_key = skey.c_str();
+        bool with_alias = alias & 1;
+        bool repeatable = alias & 2;
+        auto add = [&](auto builder){
+            if(repeatable){
+                builder.repeatable().finalize();
+            }else{
+                builder.finalize();
+            }
+        };
+        switch(kind % 9){
+            case 0:
+                with_alias ? add(parser.addArgument<bool>(short_key, key)) : add(parser.addArgument<bool>(key));
+                break;
+            case 1:
+                // implicit int, counts occurrences when repeatable
+                with_alias ? add(parser.addArgument<int>(short_key, key)) : add(parser.addArgument<int>(key));
+                break;
+            case 2:
+                with_alias ? add(parser.addArgument<int>(short_key, key).parameters("int"))
+                           : add(parser.addArgument<int>(key).parameters("int"));
+                break;
+            case 3:
+                with_alias ? add(parser.addArgument<std::string>(short_key, key).parameters("[str]"))
+                           : add(parser.addArgument<std::string>(key).parameters("[str]"));
+                break;
+            case 4:
+                add(parser.addArgument<int>(key).nargs<1,3>());
+                break;
+            case 5:
+                add(parser.addArgument<int>(key).nargs<0,-1>());
+                break;
+            case 6:
+                add(parser.addArgument<std::string>(key).nargs<2>());
+                break;
+            case 7:
+                parser.addPositional<int>(("pos" + std::to_string(i)).c_str()).finalize();
+                return;
+            default:
+                parser.addPositional<std::string>(("pos" + std::to_string(i)).c_str()).nargs<1,-1>().finalize();
+                return;
+        }
+        m_keys.push_back(lkey);
+        if(with_alias){
+            m_keys.push_back(skey);
+        }
+    }
+
+    std::string key(uint8_t arg) const {
+        return m_keys.empty() ? "--opt0" : m_keys[arg % m_keys.size()];
+    }
+
+    std::string token(uint8_t kind, uint8_t arg) const {
+        switch(kind % 10){
+            case 0:
+            case 1:
+                return key(arg);
+            case 2:
+                return key(arg) + "=" + std::to_string(arg);
+            case 3:
+                // combined short keys
+                return "-" + std::string(arg % 8 + 1, char('a' + arg % 7));
+            case 4:
+                // contiguous key and value
+                return shortKey(arg) + std::to_string(arg);
+            case 5:
+                return std::to_string(int(arg) - 128);
+            case 6:
+                // unknown key, possibly close to a known one
+                return key(arg) + char('a' + arg % 7);
+            case 7:
+                return std::string(arg % 64, char('0' + arg % 10));
+            case 8:
+                return "cmd";
+            default:
+                return "-";
+        }
+    }
+};
+
+/// Silences parser output while alive
+struct muteOutput{
+    std::streambuf *m_buf;
+    muteOutput() : m_buf(std::cout.rdbuf(nullptr)) {}
+    ~muteOutput(){
+        std::cout.rdbuf(m_buf);
+        std::cout.clear();
+    }
+};
+
+/// Registers spec from input, parses its args repeated 'repeat' times and returns time spent in parseArgs
+inline std::chrono::nanoseconds timedParse(const uint8_t *data, size_t size, size_t repeat = 1){
+    fuzzInput input(data, size);
+    argParser parser("fuzz");
+    input.buildSpec(parser);
+    auto once = input.buildArgs();
+    std::vector<std::string> args;
+    args.reserve(once.size() * repeat);
+    for(size_t i = 0; i < repeat; ++i){
+        args.insert(args.end(), once.begin(), once.end());
+    }
+    std::vector<char*> argv;
+    argv.push_back(const_cast<char*>("fuzz"));
+    for(auto &a : args){
+        argv.push_back(&a[0]);
+    }
+    muteOutput mute;
+    auto start = std::chrono::steady_clock::now();
+    try{
+        parser.parseArgs(int(argv.size()), argv.data());
+    }catch(const argParser::parse_error &){
+    }catch(const argParser::unparsed_param &){
+        // expected errors, anything else is a finding
+    }
+    return std::chrono::steady_clock::now() - start;
+}
@@ -0,0 +1,56 @@
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include "fuzz_input.hpp"
+
+/**
+ *  Fuzz target for the parse loop
+ *
+ *  Besides crashes and unexpected exceptions, it reports inputs with super-linear cost:
+ *  command line is parsed as is and repeated 8 times, the latter must not take
+ *  more than 'max_ratio' times longer.
+ *
+ *  Built with -DARGPARSER_LIBFUZZER=ON (clang), otherwise it's a standalone
+ *  executable replaying inputs from files given on command line
+ */
+
+static constexpr size_t repeat = 8;
+static constexpr double max_ratio = repeat * 4;
+// shorter runs are dominated by noise
+static constexpr auto min_duration = std::chrono::milliseconds(5);
+
+static std::chrono::nanoseconds bestOf3(const uint8_t *data, size_t size, size_t times){
+    auto best = timedParse(data, size, times);
+    for(int i = 0; i < 2; ++i){
+        best = std::min(best, timedParse(data, size, times));
+    }
+    return best;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size){
+    auto once = bestOf3(data, size, 1);
+    auto repeated = bestOf3(data, size, repeat);
+    if(repeated > min_duration && repeated.count() > max_ratio * double(once.count())){
+        std::fprintf(stderr, "super-linear parse: x1 %lld ns, x%zu %lld ns\n",
+                     (long long)once.count(), repeat, (long long)repeated.count());
+        std::abort();
+    }
+    return 0;
+}
+
+#ifndef ARGPARSER_LIBFUZZER
+int main(int argc, char *argv[]){
+    for(int i = 1; i < argc; ++i){
+        std::ifstream file(argv[i], std::ios::binary);
+        if(!file){
+            std::fprintf(stderr, "cannot open %s\n", argv[i]);
+            return 1;
+        }
+        std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        LLVMFuzzerTestOneInput(data.data(), data.size());
+        std::printf("%s: ok\n", argv[i]);
+    }
+    return 0;
+}
+#endif
@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
 #include "argparser.hpp"
+#include <thread>
+#include <deque>
+#include <fstream>
 
 #define FIXTURE Utest
 #define MYTEST(NAME) TEST_F(FIXTURE, NAME)
@@ -24,6 +27,11 @@ protected:
         args.insert(args.begin(), "binary_name");
         parser.parseArgs(int(args.size()), const_cast<char **>(&args[0]));
     }
+
+    void CallReload(std::vector<const char*> args){
+        args.insert(args.begin(), "binary_name");
+        parser.reload(int(args.size()), const_cast<char **>(&args[0]));
+    }
 };
 
 /// Common
@@ -163,6 +171,33 @@ MYTEST(MandatoryArgAtLeastOneParam){
     EXPECT_THROW(parser.addArgument<int>("i", "int").finalize(), std::invalid_argument) << "Mandatory arg's param list cannot be empty";
 }
 
+MYTEST(ManyMandatoryArgsFirstMissing){
+    // spans several words of the mandatory bitset
+    std::vector<std::string> keys;
+    for(int i = 0; i < 150; ++i){
+        keys.push_back("m" + std::to_string(i));
+        parser.addArgument<int>(keys.back().c_str()).parameters("int").finalize();
+    }
+    std::vector<const char*> args;
+    for(int i = 0; i < 150; ++i){
+        if(i != 130){
+            args.push_back(keys[i].c_str());
+            args.push_back("1");
+        }
+    }
+    EXPECT_THROW_WITH_MESSAGE(CallParser(args), argParser::parse_error, "m130 not specified");
+}
+
+MYTEST(ManyRequiredArgsOneProvided){
+    for(int i = 0; i < 100; ++i){
+        auto key = "--r" + std::to_string(i);
+        parser.addArgument<int>(key.c_str()).parameters("int").required().finalize();
+    }
+    EXPECT_NO_THROW(CallParser({"--r99", "1"}));
+    ASSERT_TRUE(parser["--r99"].isSet());
+    ASSERT_FALSE(parser["--r0"].isSet());
+}
+
 MYTEST(NullParam){
     const char *s = nullptr;
     EXPECT_THROW(parser.addArgument<int>("-i")
@@ -449,6 +484,55 @@ MYTEST(GlobalPtr){
     ASSERT_EQ(res, i) << "Global ref should work";
 }
 
+MYTEST(GlobalAtomic){
+    std::atomic<int> i{0};
+    std::atomic<bool> b{false};
+    parser.addArgument<int>("-i")
+            .parameters("int")
+            .globalPtr(&i)
+            .finalize();
+    parser.addArgument<bool>("-b")
+            .globalPtr(&b, std::memory_order_relaxed)
+            .finalize();
+    CallParser({"-i", "345", "-b"});
+    ASSERT_EQ(i.load(), 345);
+    ASSERT_TRUE(b.load());
+}
+
+MYTEST(GlobalAtomicInvalidOrder){
+    std::atomic<int> i{0};
+    EXPECT_THROW(parser.addArgument<int>("-i")
+            .parameters("int")
+            .globalPtr(&i, std::memory_order_acquire),
+            std::invalid_argument);
+}
+
+MYTEST(GlobalAtomicReload){
+    std::atomic<int> level{0};
+    parser.liveReload();
+    parser.addArgument<int>("--level")
+            .parameters("level")
+            .globalPtr(&level)
+            .finalize();
+    CallParser({"--level", "1"});
+    std::atomic<bool> done{false};
+    std::thread worker([&]{
+        int last = 0;
+        while(!done){
+            int cur = level.load(std::memory_order_acquire);
+            EXPECT_GE(cur, last) << "Published values should only grow";
+            last = cur;
+        }
+    });
+    for(int n = 2; n <= 100; ++n){
+        auto s = std::to_string(n);
+        CallReload({"--level", s.c_str()});
+    }
+    done = true;
+    worker.join();
+    ASSERT_EQ(level.load(), 100);
+}
+
 MYTEST(EqSign){
     parser.addArgument<int>("-i")
             .parameters("int")
@@ -530,6 +614,47 @@ MYTEST(SimilarKeyAsValueAdjacent){
     ASSERT_EQ(res, "-sss") << "Should parse '-sss' after '-s' as value";
 }
 
+MYTEST(CombinedArgsWithAdjacentValue){
+    parser.addArgument<int>("-v").repeatable().finalize();
+    parser.addArgument<std::string>("-s", "--str").parameters("str").finalize();
+    CallParser({"-vvsabc", "-vv"});
+    EXPECT_EQ(parser.getValue<int>("-v"), 4);
+    EXPECT_EQ(parser.getValue<std::string>("-s"), "abc");
+}
+
+MYTEST(CombinedArgsWithLongerKeyRemainder){
+    parser.addArgument<int>("-v").repeatable().finalize();
+    parser.addArgument<bool>("-vx", "-w").finalize();
+    parser.addArgument<int>("n").parameters("int").finalize();
+    CallParser({"-vvx", "n5"});
+    EXPECT_EQ(parser.getValue<int>("-v"), 1);
+    EXPECT_TRUE(parser.getValue<bool>("-vx")) << "remainder which is a key itself should be parsed as key";
+    EXPECT_EQ(parser.getValue<int>("n"), 5) << "non-minus contiguous value";
+}
+
+/// Complexity regressions (found by fuzz_complexity), take seconds if parsing is quadratic
+MYTEST(ManyEqSignTokens){
+    parser.addArgument<int>("-i").parameters("int").repeatable().finalize();
+    std::vector<const char*> args(50000, "-i=1");
+    args.push_back("-i=2");
+    CallParser(args);
+    EXPECT_EQ(parser.getValue<int>("-i"), 2);
+}
+
+MYTEST(LongCombinedArgs){
+    parser.addArgument<int>("-v").repeatable().finalize();
+    std::string combined = "-" + std::string(100000, 'v');
+    CallParser({combined.c_str()});
+    EXPECT_EQ(parser.getValue<int>("-v"), 100000);
+}
+
+MYTEST(LongUnknownToken){
+    parser.addArgument<int>("--option").parameters("int").finalize();
+    parser.addPositional<int>("pos").finalize();
+    std::string token = "--" + std::string(1000000, 'o');
+    EXPECT_THROW(CallParser({token.c_str()}), argParser::unparsed_param);
+}
+
 MYTEST(VariadicOpt){
     parser.addArgument<int>("--variadic", "-var")
             .nargs<1, -1>()
@@ -1282,6 +1407,107 @@ MYTEST(NargsForMandatoryArgWithParam){
     ASSERT_EQ(parser.getValue<int>("i"), 543);
 }
 
+MYTEST(NargsWideRange){
+    parser.addArgument<int>("-n").nargs<1, 100000>().finalize();
+    parser.addPositional<int>("pos").finalize();
+    CallParser({"-n", "1", "2", "3", "4"});
+    bool check = parser.getValue<std::vector<int>>("-n") == std::vector<int>{1, 2, 3};
+    ASSERT_TRUE(check);
+    ASSERT_EQ(parser.getValue<int>("pos"), 4);
+    parser.addPositional<int>("rest").nargs<0, 100000>().finalize();
+    EXPECT_THROW(parser.addPositional<int>("last"), std::invalid_argument) << "Positional after optional nargs";
+}
+
+/// Sinks
+
+MYTEST(SinkCallable){
+    std::vector<std::string> files;
+    parser.addPositional<std::string>("files")
+            .nargs<1, -1>()
+            .sink([&files](std::string &&f){ files.push_back(std::move(f)); })
+            .finalize();
+    CallParser({"a", "b", "c"});
+    bool check = files == std::vector<std::string>{"a", "b", "c"};
+    ASSERT_TRUE(check);
+    ASSERT_TRUE(parser.getValue<std::vector<std::string>>("files").empty()) << "Values should not be stored";
+}
+
+MYTEST(SinkOutputIterator){
+    std::vector<int> values;
+    auto func = [](const char *arg){ return int(std::strtol(arg, nullptr, 0)) * 2; };
+    parser.addArgument<int>("-n")
+            .callable(func)
+            .nargs<2, 3>()
+            .sink(std::back_inserter(values))
+            .finalize();
+    CallParser({"-n", "1", "2", "3"});
+    bool check = values == std::vector<int>{2, 4, 6};
+    ASSERT_TRUE(check);
+}
+
+MYTEST(AppendToResetParse){
+    std::vector<std::string> files{"existing"};
+    parser.addPositional<std::string>("files").nargs<1, -1>().appendTo(&files).finalize();
+    CallParser({"a", "b"});
+    parser.resetParse();
+    CallParser({"c"});
+    EXPECT_EQ(files, (std::vector<std::string>{"existing", "c"})) << "Values of previous parse should be dropped";
+}
+
+MYTEST(AppendToLiveReload){
+    std::vector<int> values;
+    parser.liveReload();
+    auto append_live = [&]{ parser.addArgument<int>("-l").nargs<1, -1>().appendTo(&values).finalize(); };
+    EXPECT_THROW(append_live(), std::logic_error) << "Container cannot be updated atomically";
+}
+
+MYTEST(AppendToContainers){
+    std::vector<std::string> files{"existing"};
+    std::deque<int> numbers;
+    parser.addPositional<std::string>("files").nargs<1, -1>().appendTo(&files).finalize();
+    parser.addArgument<int>("-n").nargs<2>().appendTo(&numbers).finalize();
+    CallParser({"-n", "1", "2", "a", "b"});
+    bool check = files == std::vector<std::string>{"existing", "a", "b"} && numbers == std::deque<int>{1, 2};
+    ASSERT_TRUE(check);
+    ASSERT_GE(files.capacity(), 3);
+    ASSERT_TRUE(parser.getValue<std::vector<int>>("-n").empty());
+    std::vector<int> *null_container = nullptr;
+    auto append_to_null = [&]{ parser.addArgument<int>("-l").nargs<1, -1>().appendTo(null_container); };
+    EXPECT_THROW(append_to_null(), std::invalid_argument);
+}
+
+MYTEST(SinkElementIndexInError){
+    std::vector<int> values;
+    parser.addArgument<int>("-n")
+            .nargs<0, -1>()
+            .choices(1, 2)
+            .sink(std::back_inserter(values))
+            .finalize();
+    EXPECT_THROW_WITH_MESSAGE(CallParser({"-n", "1", "2", "3"}), argParser::unparsed_param,
+                              "-n : element 2: value does not correspond to any of given choices");
+    ASSERT_EQ(values.size(), 2) << "Values before invalid one should reach sink";
+}
+
+MYTEST(VariadicElementIndexInError){
+    parser.addArgument<int>("-n").nargs<0, -1>().finalize();
+    EXPECT_THROW_WITH_MESSAGE(CallParser({"-n", "1", "x"}), argParser::unparsed_param,
+                              "-n : element 1: scan_number: could not convert x to int");
+}
+
+MYTEST(SinkNotVariadic){
+    std::vector<int> values;
+    EXPECT_THROW(parser.addArgument<int>("-n").parameters("n").sink(std::back_inserter(values)).finalize(), std::logic_error);
+    auto lazy_sink = [&]{
+        parser.addArgument<int>("-v")
+                .callable([](const char *a){ return std::atoi(a); })
+                .nargs<1, -1>()
+                .lazy()
+                .sink(std::back_inserter(values))
+                .finalize();
+    };
+    EXPECT_THROW(lazy_sink(), std::logic_error);
+}
+
 MYTEST(ChildParser){
     auto &child = parser.addCommand("child", "child parser");
     child.addArgument<int>("--int")
@@ -1382,5 +1608,1012 @@ MYTEST(ChildWithCallback){
     ASSERT_EQ(val, 555);
 }
 
+/// Lazy callables
+MYTEST(LazyCallable){
+    int calls = 0;
+    parser.addArgument<int>("-l")
+            .parameters("int")
+            .callable([&calls](const char *arg){ ++calls; return std::stoi(arg); })
+            .lazy()
+            .finalize();
+    CallParser({"-l", "42"});
+    EXPECT_EQ(calls, 0) << "Callable shouldn't run while parsing";
+    EXPECT_EQ(parser.getValue<int>("-l"), 42);
+    int val = parser["-l"];
+    EXPECT_EQ(val, 42);
+    EXPECT_EQ(calls, 1) << "Callable should run once";
+}
+
+MYTEST(LazyCallableNotSet){
+    int calls = 0;
+    parser.addArgument<int>("-l")
+            .parameters("int")
+            .callable([&calls](const char *arg){ ++calls; return std::stoi(arg); })
+            .defaultValue(5)
+            .lazy()
+            .finalize();
+    CallParser({});
+    EXPECT_EQ(parser.getValue<int>("-l"), 5);
+    EXPECT_EQ(calls, 0);
+}
+
+MYTEST(LazyCallableVariadic){
+    parser.addArgument<int>("-l")
+            .callable([](const char *arg){ return std::stoi(arg) * 2; })
+            .nargs<1,-1>()
+            .lazy()
+            .finalize();
+    parser.addArgument<int>("-i").parameters("int").finalize();
+    CallParser({"-l", "1", "2", "3", "-i", "4"});
+    bool check = parser.getValue<std::vector<int>>("-l") == std::vector<int>{2, 4, 6};
+    EXPECT_TRUE(check);
+}
+
+MYTEST(LazyCallableErrorOnRead){
+    parser.addArgument<int>("-l")
+            .parameters("int")
+            .callable([](const char *arg) -> int { throw std::runtime_error(std::string("cannot load ") + arg); })
+            .lazy()
+            .finalize();
+    EXPECT_NO_THROW(CallParser({"-l", "file"}));
+    EXPECT_THROW_WITH_MESSAGE(parser.getValue<int>("-l"), argParser::unparsed_param, "-l : cannot load file");
+    EXPECT_THROW(parser.getValue<int>("-l"), argParser::unparsed_param) << "Error should be reported on every read";
+    try{
+        (void)parser.getValue<int>("-l");
+    }catch(const argParser::unparsed_param &e){
+        EXPECT_EQ(e.name(), "-l");
+        EXPECT_EQ(e.cli(), std::vector<std::string>{"file"});
+    }
+}
+
+MYTEST(LazyCallableConcurrentReads){
+    std::atomic<int> calls{0};
+    parser.addArgument<int>("-l")
+            .parameters("int")
+            .callable([&calls](const char *arg){
+                ++calls;
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                return std::stoi(arg);
+            })
+            .lazy()
+            .finalize();
+    CallParser({"-l", "7"});
+    std::vector<std::thread> readers;
+    std::atomic<int> sum{0};
+    for(int i = 0; i < 8; ++i){
+        readers.emplace_back([&]{ sum += parser.getValue<int>("-l"); });
+    }
+    for(auto &t : readers){
+        t.join();
+    }
+    EXPECT_EQ(calls, 1);
+    EXPECT_EQ(sum, 56);
+}
+
+MYTEST(LazyCallableRepeatable){
+    EXPECT_THROW(parser.addArgument<int>("-l")
+            .callable([]{ return 1; })
+            .lazy()
+            .repeatable()
+            .finalize(), std::logic_error);
+}
+
+/// Parallel callables
+MYTEST(ParallelCallables){
+    // each callable waits for the others, so it completes only if they run concurrently
+    std::atomic<int> started{0};
+    auto load = [&started](const char *arg){
+        ++started;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while(started < 3 && std::chrono::steady_clock::now() < deadline){
+            std::this_thread::yield();
+        }
+        return started == 3 ? std::string(arg) : std::string("sequential");
+    };
+    parser.parallelActions(true, 3);
+    parser.addArgument<std::string>("--index").parameters("file").callable(load).parallel().finalize();
+    parser.addArgument<std::string>("--model").parameters("file").callable(load).parallel().finalize();
+    parser.addArgument<std::string>("--dict").parameters("file").callable(load).parallel().finalize();
+    CallParser({"--index", "a.idx", "--model", "b.bin", "--dict", "c.txt"});
+    EXPECT_EQ(parser.getValue<std::string>("--index"), "a.idx");
+    EXPECT_EQ(parser.getValue<std::string>("--model"), "b.bin");
+    EXPECT_EQ(parser.getValue<std::string>("--dict"), "c.txt");
+}
+
+MYTEST(ParallelCallablesLimited){
+    std::atomic<int> running{0};
+    std::atomic<int> max_running{0};
+    auto load = [&](const char *arg){
+        auto now = ++running;
+        for(auto seen = max_running.load(); now > seen && !max_running.compare_exchange_weak(seen, now);){}
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        --running;
+        return std::stoi(arg);
+    };
+    parser.parallelActions(true, 2);
+    std::vector<std::string> keys;
+    std::vector<const char*> args;
+    for(int i = 0; i < 8; ++i){
+        keys.push_back("--load-" + std::to_string(i));
+    }
+    for(const auto &key : keys){
+        parser.addArgument<int>(key.c_str()).parameters("int").callable(load).parallel().finalize();
+        args.insert(args.end(), {key.c_str(), "1"});
+    }
+    CallParser(args);
+    EXPECT_LE(max_running, 2) << "at most 2 actions should run at once";
+    for(const auto &key : keys){
+        EXPECT_EQ(parser.getValue<int>(key), 1);
+    }
+}
+
+MYTEST(ParallelCallablesDisabled){
+    auto main_id = std::this_thread::get_id();
+    bool same_thread = false;
+    parser.addArgument<int>("-p")
+            .parameters("int")
+            .callable([&](const char *arg){ same_thread = std::this_thread::get_id() == main_id; return std::stoi(arg); })
+            .parallel()
+            .finalize();
+    CallParser({"-p", "1"});
+    EXPECT_TRUE(same_thread) << "Without parallelActions() callables run while parsing";
+}
+
+MYTEST(ParallelCallablesFinishBeforeCallback){
+    std::atomic<int> done{0};
+    int seen_in_callback = -1;
+    auto slow = [&done](const char *arg){
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        ++done;
+        return std::stoi(arg);
+    };
+    parser.parallelActions();
+    parser.addArgument<int>("-a").parameters("int").callable(slow).parallel().finalize();
+    parser.addArgument<int>("-b").parameters("int").callable(slow).parallel().finalize();
+    parser.setCallback([&]{ seen_in_callback = done; });
+    CallParser({"-a", "1", "-b", "2"});
+    EXPECT_EQ(seen_in_callback, 2);
+    EXPECT_EQ(parser.getValue<int>("-a") + parser.getValue<int>("-b"), 3);
+}
+
+MYTEST(ParallelCallablesError){
+    auto conv = [](const char *arg){
+        if(std::string(arg) == "bad"){
+            throw std::runtime_error("cannot load");
+        }
+        return std::string(arg);
+    };
+    parser.parallelActions();
+    parser.addArgument<std::string>("-a").parameters("file").callable(conv).parallel().finalize();
+    parser.addArgument<std::string>("-b").parameters("file").callable(conv).parallel().finalize();
+    try{
+        CallParser({"-a", "good", "-b", "bad"});
+        FAIL() << "Expected unparsed_param";
+    }catch(const argParser::unparsed_param &e){
+        EXPECT_EQ(e.name(), "-b");
+        EXPECT_EQ(e.cli(), std::vector<std::string>{"bad"});
+        EXPECT_STREQ(e.what(), "-b : cannot load");
+    }
+}
+
+MYTEST(ParallelCallableRepeatable){
+    EXPECT_THROW(parser.addArgument<int>("-p")
+            .callable([]{ return 1; })
+            .parallel()
+            .repeatable()
+            .finalize(), std::logic_error);
+}
+
+/// Default providers
+MYTEST(DefaultProviderNotCalledIfSet){
+    int calls = 0;
+    parser.addArgument<int>("-j").parameters("n").defaultProvider([&calls]{ ++calls; return 8; }).finalize();
+    CallParser({"-j", "2"});
+    ASSERT_EQ(parser.getValue<int>("-j"), 2);
+    ASSERT_EQ(calls, 0);
+}
+
+MYTEST(DefaultProviderCalledOnceOnRead){
+    int calls = 0;
+    parser.addArgument<int>("-j").parameters("n").defaultProvider([&calls]{ ++calls; return 8; }).finalize();
+    CallParser({});
+    ASSERT_EQ(calls, 0) << "Provider should run only when value is read";
+    ASSERT_EQ(parser.getValue<int>("-j"), 8);
+    int j = parser["-j"];
+    ASSERT_EQ(j, 8);
+    ASSERT_EQ(calls, 1);
+    ASSERT_FALSE(parser["-j"].isSet());
+}
+
+MYTEST(DefaultProviderMemoizedOnReload){
+    int calls = 0;
+    parser.addArgument<std::string>("--host").parameters("name")
+            .defaultProvider([&calls]{ ++calls; return std::string("localhost"); }).finalize();
+    parser.liveReload();
+    CallParser({});
+    ASSERT_EQ(parser.values().getValue<std::string>("--host"), "localhost");
+    CallReload({"--host", "remote"});
+    ASSERT_EQ(parser.getValue<std::string>("--host"), "remote");
+    CallReload({});
+    ASSERT_EQ(parser.getValue<std::string>("--host"), "localhost");
+    ASSERT_EQ(calls, 1);
+}
+
+MYTEST(DefaultProviderError){
+    parser.addArgument<int>("-j").parameters("n").defaultProvider([]() -> int { throw std::runtime_error("no cpus"); }).finalize();
+    CallParser({});
+    EXPECT_THROW_WITH_MESSAGE(parser.getValue<int>("-j"), std::runtime_error, "no cpus");
+}
+
+MYTEST(DefaultProviderWithDefaultValue){
+    int global = 0;
+    auto with_default = [&]{ parser.addArgument<int>("-a").parameters("n").defaultValue(1).defaultProvider([]{ return 2; }).finalize(); };
+    auto with_global = [&]{ parser.addArgument<int>("-b").parameters("n").globalPtr(&global).defaultProvider([]{ return 2; }).finalize(); };
+    EXPECT_THROW(with_default(), std::logic_error);
+    EXPECT_THROW(with_global(), std::logic_error);
+}
+
+/// Constraints
+MYTEST(ExclusiveGroup){
+    parser.addArgument<bool>("--json").finalize();
+    parser.addArgument<bool>("-x", "--xml").finalize();
+    parser.addExclusiveGroup({"--json", "-x"});
+    EXPECT_NO_THROW(CallParser({"--xml"}));
+    ASSERT_TRUE(parser["--xml"].isSet());
+}
+
+MYTEST(ExclusiveGroupViolated){
+    parser.addArgument<bool>("--json").finalize();
+    parser.addArgument<bool>("-x", "--xml").finalize();
+    parser.addExclusiveGroup({"--json", "-x"});
+    EXPECT_THROW_WITH_MESSAGE(CallParser({"--xml", "--json"}), argParser::parse_error, "--json and --xml are mutually exclusive");
+}
+
+MYTEST(ExclusiveGroupRequired){
+    parser.addArgument<bool>("--json").finalize();
+    parser.addArgument<bool>("--xml").finalize();
+    parser.addArgument<bool>("--yaml").finalize();
+    parser.addExclusiveGroup({"--yaml", "--json", "--xml"}, true);
+    EXPECT_THROW_WITH_MESSAGE(CallParser({}), argParser::parse_error, "one of --json, --xml, --yaml is required");
+}
 
+MYTEST(ExclusiveGroupRequiredOneOf){
+    parser.addArgument<bool>("--json").finalize();
+    parser.addArgument<bool>("--xml").finalize();
+    parser.addExclusiveGroup({"--json", "--xml"}, true);
+    EXPECT_NO_THROW(CallParser({"--xml"}));
+}
+
+MYTEST(Dependency){
+    parser.addArgument<std::string>("--user").parameters("name").finalize();
+    parser.addArgument<std::string>("--password").parameters("pwd").finalize();
+    parser.addArgument<std::string>("--host").parameters("host").finalize();
+    parser.addDependency("--user", {"--host", "--password"});
+    EXPECT_THROW_WITH_MESSAGE(CallParser({"--user", "me", "--host", "h"}), argParser::parse_error, "--user requires --password");
+}
 
+MYTEST(DependencySatisfied){
+    parser.addArgument<std::string>("--user").parameters("name").finalize();
+    parser.addArgument<std::string>("--password").parameters("pwd").finalize();
+    parser.addDependency("--user", {"--password"});
+    EXPECT_NO_THROW(CallParser({"--password", "p"})) << "Dependency is checked only if argument is set";
+}
+
+MYTEST(Conflict){
+    parser.addArgument<bool>("-q", "--quiet").finalize();
+    parser.addArgument<int>("-v").repeatable().finalize();
+    parser.addConflict("--quiet", {"-v"});
+    EXPECT_NO_THROW(CallParser({"-vv"}));
+}
+
+MYTEST(ConflictViolated){
+    parser.addArgument<bool>("-q", "--quiet").finalize();
+    parser.addArgument<int>("-v").repeatable().finalize();
+    parser.addConflict("-q", {"-v"});
+    EXPECT_THROW_WITH_MESSAGE(CallParser({"-vqv"}), argParser::parse_error, "--quiet conflicts with -v");
+}
+
+MYTEST(ConstraintInvalidKeys){
+    parser.addArgument<bool>("--a").finalize();
+    parser.addPositional<int>("pos").finalize();
+    EXPECT_THROW(parser.addExclusiveGroup({"--a"}), std::invalid_argument);
+    EXPECT_THROW(parser.addExclusiveGroup({"--a", "--b"}), std::invalid_argument);
+    EXPECT_THROW(parser.addDependency("--a", {}), std::invalid_argument);
+    EXPECT_THROW(parser.addConflict("--a", {"pos"}), std::invalid_argument);
+}
+
+MYTEST(ConstraintSelfReference){
+    parser.addArgument<bool>("-x", "--extra").finalize();
+    parser.addArgument<bool>("-y").finalize();
+    EXPECT_THROW_WITH_MESSAGE(parser.addConflict("-x", {"-x"}), std::invalid_argument, "addConflict: -x cannot refer to itself");
+    EXPECT_THROW_WITH_MESSAGE(parser.addDependency("--extra", {"-y", "-x"}), std::invalid_argument, "addDependency: --extra cannot refer to itself");
+    EXPECT_NO_THROW(CallParser({"-x"})) << "rejected constraints should not be added";
+}
+
+MYTEST(ManyConstraints){
+    for(int i = 0; i < 300; ++i){
+        auto key = "--o" + std::to_string(i);
+        parser.addArgument<bool>(key.c_str()).finalize();
+    }
+    for(int i = 0; i < 299; i += 2){
+        parser.addExclusiveGroup({"--o" + std::to_string(i), "--o" + std::to_string(i + 1)});
+        parser.addDependency("--o" + std::to_string(i), {"--o" + std::to_string(299 - i)});
+    }
+    EXPECT_THROW_WITH_MESSAGE(CallParser({"--o298", "--o2"}), argParser::parse_error, "--o2 requires --o297");
+}
+
+/// Command line string
+MYTEST(SplitCommandLine){
+    std::deque<std::string> unescaped;
+    auto tokens = argParser::splitCommandLine(R"(  -i  5	--str 'a b'"c \" d"e\ f "" x\
+y 'it'\''s' "\n")", unescaped);
+    std::vector<std::string_view> expected{"-i", "5", "--str", "a bc \" de f", "", "xy", "it's", "\\n"};
+    EXPECT_EQ(tokens, expected);
+    // continuation followed by indentation
+    tokens = argParser::splitCommandLine("-a 1 \\\n  -b 2 \\\n", unescaped);
+    expected = {"-a", "1", "-b", "2"};
+    EXPECT_EQ(tokens, expected);
+}
+
+MYTEST(SplitCommandLineViews){
+    std::string line(100, 'a');
+    line += " --long-option-name=value 'quoted'";
+    std::deque<std::string> unescaped;
+    auto tokens = argParser::splitCommandLine(line, unescaped);
+    ASSERT_EQ(tokens.size(), 3);
+    EXPECT_EQ(tokens[0].data(), line.data()) << "plain tokens should point into the line";
+    EXPECT_EQ(tokens[1].data(), line.data() + 101);
+    EXPECT_EQ(tokens[1], "--long-option-name=value");
+    EXPECT_EQ(unescaped.size(), 1);
+    EXPECT_EQ(tokens[2], "quoted");
+}
+
+MYTEST(SplitCommandLineErrors){
+    std::deque<std::string> unescaped;
+    EXPECT_THROW_WITH_MESSAGE(argParser::splitCommandLine("-s 'abc", unescaped), argParser::parse_error, "Unterminated quote in command line");
+    EXPECT_THROW_WITH_MESSAGE(argParser::splitCommandLine(R"(-s "abc\")", unescaped), argParser::parse_error, "Unterminated quote in command line");
+    EXPECT_THROW_WITH_MESSAGE(argParser::splitCommandLine("-s abc\\", unescaped), argParser::parse_error, "Command line ends with escape character");
+    EXPECT_TRUE(argParser::splitCommandLine(" \t\n ", unescaped).empty());
+}
+
+MYTEST(ParseCommandLine){
+    parser.addArgument<int>("-i").parameters("int").finalize();
+    parser.addArgument<std::string>("--str").parameters("str").finalize();
+    parser.addPositional<std::string>("pos").finalize();
+    EXPECT_EQ(parser.parseCommandLine(R"(-i 42 --str "hello world" 'pos arg')"), 5);
+    EXPECT_EQ(parser.getValue<int>("-i"), 42);
+    EXPECT_EQ(parser.getValue<std::string>("--str"), "hello world");
+    EXPECT_EQ(parser.getValue<std::string>("pos"), "pos arg");
+    EXPECT_THROW(parser.parseCommandLine("-i 1 x"), argParser::parse_error) << "Should not parse twice";
+}
+
+/// Response files
+static std::string WriteResponseFile(const std::string &name, const std::string &contents){
+    auto path = testing::TempDir() + name;
+    std::ofstream(path) << contents;
+    return "@" + path;
+}
+
+MYTEST(ResponseFile){
+    parser.addArgument<int>("-i", "--int").parameters("int").finalize();
+    parser.addArgument<int>("-v").repeatable().finalize();
+    parser.addArgument<std::string>("--str").parameters("str").finalize();
+    parser.addPositional<std::string>("pos").finalize();
+    parser.responseFiles();
+    auto file = WriteResponseFile("argparser_rsp1", "--int=5 -vv\n--str 'a b'\n");
+    EXPECT_NO_THROW(CallParser({file.c_str(), "pos"}));
+    EXPECT_EQ(parser.getValue<int>("-i"), 5);
+    EXPECT_EQ(parser.getValue<int>("-v"), 2) << "combined flags from file should be split";
+    EXPECT_EQ(parser.getValue<std::string>("--str"), "a b");
+    EXPECT_EQ(parser.getValue<std::string>("pos"), "pos");
+}
+
+MYTEST(ResponseFileNested){
+    parser.addArgument<int>("-i").parameters("int").finalize();
+    parser.addArgument<int>("-j").parameters("int").finalize();
+    parser.responseFiles();
+    auto inner = WriteResponseFile("argparser_rsp_inner", "-j 2");
+    auto outer = WriteResponseFile("argparser_rsp_outer", "-i 1 " + inner);
+    EXPECT_NO_THROW(CallParser({outer.c_str()}));
+    EXPECT_EQ(parser.getValue<int>("-i"), 1);
+    EXPECT_EQ(parser.getValue<int>("-j"), 2);
+}
+
+MYTEST(ResponseFileRecursion){
+    parser.addArgument<int>("-i").parameters("int").repeatable().finalize();
+    parser.responseFiles(true, 3);
+    auto file = WriteResponseFile("argparser_rsp_self", "");
+    WriteResponseFile("argparser_rsp_self", "-i 1 " + file);
+    EXPECT_THROW_WITH_MESSAGE(CallParser({file.c_str()}), argParser::parse_error,
+                              file + ": response files nested deeper than 3");
+}
+
+MYTEST(ResponseFileDisabled){
+    parser.addPositional<std::string>("pos").finalize();
+    parser.addArgument<std::string>("--str").parameters("str").finalize();
+    auto file = WriteResponseFile("argparser_rsp_disabled", "--str abc");
+    EXPECT_NO_THROW(CallParser({file.c_str()}));
+    EXPECT_EQ(parser.getValue<std::string>("pos"), file) << "expanded only if enabled";
+}
+
+MYTEST(ResponseFileMissing){
+    parser.addPositional<std::string>("pos").finalize();
+    parser.responseFiles();
+    EXPECT_NO_THROW(CallParser({"@no/such/file"}));
+    EXPECT_EQ(parser.getValue<std::string>("pos"), "@no/such/file") << "token should be kept if file can't be opened";
+}
+
+MYTEST(ResponseFileUnterminatedQuote){
+    parser.addArgument<std::string>("--str").parameters("str").finalize();
+    parser.responseFiles();
+    auto file = WriteResponseFile("argparser_rsp_quote", "--str 'abc");
+    EXPECT_THROW_WITH_MESSAGE(CallParser({file.c_str()}), argParser::parse_error,
+                              file + ": Unterminated quote in command line");
+}
+
+/// Known args
+MYTEST(ParseKnownArgs){
+    parser.addArgument<int>("-i", "--int").parameters("int").finalize();
+    parser.addArgument<bool>("-v").finalize();
+    parser.addPositional<std::string>("pos").finalize();
+    std::vector<const char*> args{"binary_name", "--unknown=1", "-i", "5", "pos", "-x", "value", "-v", "--", "-i", "tail"};
+    auto argv = const_cast<char **>(&args[0]);
+    EXPECT_NO_THROW(parser.parseKnownArgs(int(args.size()), argv));
+    EXPECT_EQ(parser.getValue<int>("-i"), 5);
+    EXPECT_TRUE(parser.getValue<bool>("-v"));
+    EXPECT_EQ(parser.getValue<std::string>("pos"), "pos");
+    ASSERT_EQ(parser.unknownArgsCount(), 5);
+    auto unknown = parser.unknownArgs();
+    const std::vector<char*> expected{argv[1], argv[5], argv[6], argv[9], argv[10], nullptr};
+    EXPECT_EQ(std::vector<char*>(unknown, unknown + 6), expected) << "should point to original argv";
+}
+
+MYTEST(ParseKnownArgsCommand){
+    auto &child = parser.addCommand("child", "");
+    child.addArgument<int>("--child-int").parameters("int").finalize();
+    std::vector<const char*> args{"binary_name", "--unknown", "child", "--child-int", "1", "--child-unknown"};
+    auto argv = const_cast<char **>(&args[0]);
+    EXPECT_NO_THROW(parser.parseKnownArgs(int(args.size()), argv));
+    EXPECT_EQ(child.getValue<int>("--child-int"), 1);
+    ASSERT_EQ(parser.unknownArgsCount(), 2);
+    EXPECT_EQ(parser.unknownArgs()[0], argv[1]);
+    EXPECT_EQ(parser.unknownArgs()[1], argv[5]);
+}
+
+MYTEST(ParseKnownArgsPartiallyKnown){
+    parser.addArgument<bool>("-v").finalize();
+    std::vector<const char*> args{"binary_name", "-vx"};
+    EXPECT_THROW_WITH_MESSAGE(parser.parseKnownArgs(int(args.size()), const_cast<char **>(&args[0])),
+                              argParser::parse_error, "-vx: unknown argument");
+}
+
+MYTEST(ParseKnownArgsStillChecksKnown){
+    parser.addArgument<int>("-i").parameters("int").mandatory().finalize();
+    std::vector<const char*> args{"binary_name", "--", "-i", "1"};
+    EXPECT_THROW_WITH_MESSAGE(parser.parseKnownArgs(int(args.size()), const_cast<char **>(&args[0])),
+                              argParser::parse_error, "-i not specified");
+}
+
+MYTEST(UnknownArgsAfterParseArgs){
+    CallParser({});
+    EXPECT_EQ(parser.unknownArgsCount(), 0);
+    EXPECT_EQ(parser.unknownArgs()[0], nullptr);
+}
+
+/// Bootstrap
+MYTEST(ParseBootstrap){
+    parser.addArgument<std::string>("-c", "--config").parameters("file").finalize();
+    parser.addArgument<int>("--log-level").parameters("level").defaultValue(1).finalize();
+    std::vector<const char*> args{"binary_name", "--plugin", "x", "--config=app.cfg", "-i", "5", "--log-level", "3", "pos"};
+    auto argv = const_cast<char **>(&args[0]);
+    EXPECT_EQ(parser.parseBootstrap(int(args.size()), argv), 2);
+    EXPECT_EQ(parser.getValue<std::string>("--config"), "app.cfg");
+    EXPECT_EQ(parser.getValue<int>("--log-level"), 3);
+    EXPECT_FALSE(parser.parsed());
+    // rest of the spec
+    parser.addArgument<std::string>("--plugin").parameters("name").finalize();
+    parser.addArgument<int>("-i").parameters("int").finalize();
+    parser.addPositional<std::string>("pos").finalize();
+    EXPECT_NO_THROW(parser.parseArgs(int(args.size()), argv)) << "bootstrap options shouldn't be redefined";
+    EXPECT_EQ(parser.getValue<std::string>("--config"), "app.cfg");
+    EXPECT_EQ(parser.getValue<int>("--log-level"), 3);
+    EXPECT_EQ(parser.getValue<int>("-i"), 5);
+    EXPECT_EQ(parser.getValue<std::string>("pos"), "pos");
+}
+
+MYTEST(ParseBootstrapArity){
+    parser.addArgument<int>("-n").nargs<2>().finalize();
+    parser.addArgument<bool>("-v").finalize();
+    std::vector<const char*> args{"binary_name", "-n", "1", "-2", "-v", "--", "-v"};
+    EXPECT_EQ(parser.parseBootstrap(int(args.size()), const_cast<char **>(&args[0])), 2);
+    EXPECT_EQ(parser.getValue<std::vector<int>>("-n"), std::vector<int>({1, -2}));
+    EXPECT_TRUE(parser.getValue<bool>("-v"));
+    std::vector<const char*> missing{"binary_name", "-n", "1"};
+    EXPECT_THROW_WITH_MESSAGE(parser.parseBootstrap(int(missing.size()), const_cast<char **>(&missing[0])),
+                              argParser::parse_error, "-n requires 2 parameters, but 1 were provided");
+}
+
+MYTEST(ParseBootstrapLazy){
+    parser.addArgument<std::string>("--plugins")
+            .parameters("dir")
+            .callable([](const char *a){ return std::string(a) + "/lib"; })
+            .lazy()
+            .finalize();
+    std::vector<const char*> args{"binary_name", "--plugins", "/opt/app", "-x"};
+    EXPECT_EQ(parser.parseBootstrap(int(args.size()), const_cast<char **>(&args[0])), 1);
+    EXPECT_EQ(parser.getValue<std::string>("--plugins"), "/opt/app/lib") << "values of deferred action should outlive bootstrap";
+}
+
+MYTEST(ParseBootstrapAppendTo){
+    std::vector<std::string> files;
+    parser.addArgument<std::string>("--files").nargs<1, -1>().appendTo(&files).finalize();
+    std::vector<const char*> args{"binary_name", "--files", "a", "b"};
+    auto argv = const_cast<char **>(&args[0]);
+    EXPECT_EQ(parser.parseBootstrap(int(args.size()), argv), 1);
+    EXPECT_TRUE(files.empty()) << "values are delivered by full parse";
+    EXPECT_NO_THROW(parser.parseArgs(int(args.size()), argv));
+    EXPECT_EQ(files, std::vector<std::string>({"a", "b"}));
+}
+
+MYTEST(ParseBootstrapConversionError){
+    parser.addArgument<int>("--log-level").parameters("level").finalize();
+    std::vector<const char*> args{"binary_name", "--log-level", "high"};
+    EXPECT_THROW(parser.parseBootstrap(int(args.size()), const_cast<char **>(&args[0])), argParser::unparsed_param);
+}
+
+MYTEST(ParseBootstrapCombined){
+    parser.addArgument<bool>("-v").finalize();
+    parser.addArgument<int>("-k").parameters("int").finalize();
+    std::vector<const char*> args{"binary_name", "-vq", "-k123"};
+    auto argv = const_cast<char **>(&args[0]);
+    EXPECT_EQ(parser.parseBootstrap(int(args.size()), argv), 2);
+    EXPECT_TRUE(parser.getValue<bool>("-v")) << "known part of combined flags should be found";
+    EXPECT_EQ(parser.getValue<int>("-k"), 123);
+    parser.addArgument<bool>("-q").finalize();
+    EXPECT_NO_THROW(parser.parseArgs(int(args.size()), argv));
+    EXPECT_TRUE(parser.getValue<bool>("-v"));
+    EXPECT_TRUE(parser.getValue<bool>("-q"));
+    EXPECT_EQ(parser.getValue<int>("-k"), 123);
+}
+
+MYTEST(ParseBootstrapResponseFile){
+    parser.addArgument<std::string>("--config").parameters("file").finalize();
+    parser.responseFiles();
+    auto file = WriteResponseFile("argparser_rsp_bootstrap", "--plugin x --config app.cfg");
+    std::vector<const char*> args{"binary_name", file.c_str()};
+    EXPECT_EQ(parser.parseBootstrap(int(args.size()), const_cast<char **>(&args[0])), 1);
+    EXPECT_EQ(parser.getValue<std::string>("--config"), "app.cfg");
+}
+
+/// NUL-separated command line
+MYTEST(ParseCmdline){
+    parser.addArgument<std::string>("--agent-log").parameters("file").finalize();
+    parser.addArgument<bool>("--agent-verbose").finalize();
+    using namespace std::string_literals;
+    EXPECT_NO_THROW(parser.parseCmdline("/usr/bin/host\0--host-opt\0--agent-log=a.log\0--agent-verbose\0input"s));
+    EXPECT_EQ(parser.getValue<std::string>("--agent-log"), "a.log");
+    EXPECT_TRUE(parser.getValue<bool>("--agent-verbose"));
+    ASSERT_EQ(parser.unknownArgsCount(), 2) << "host program options should be passed through";
+    EXPECT_STREQ(parser.unknownArgs()[0], "--host-opt");
+    EXPECT_STREQ(parser.unknownArgs()[1], "input");
+    EXPECT_EQ(parser.getSelfName(), "host");
+    EXPECT_THROW_WITH_MESSAGE(parser.parseCmdline("/usr/bin/host\0--agent-log=b.log"s), argParser::parse_error,
+                              "Repeated attempt to run parseCmdline");
+    EXPECT_EQ(parser.getValue<std::string>("--agent-log"), "a.log");
+    EXPECT_STREQ(parser.unknownArgs()[0], "--host-opt") << "values of the last parse should stay valid";
+}
+
+MYTEST(ParseCmdlineBulk){
+    parser.addArgument<int>("-i").parameters("int").finalize();
+    parser.addPositional<std::string>("pos").finalize();
+    using namespace std::string_literals;
+    const std::vector<std::string> buffers{"a\0-i\0" "1\0x\0"s, "b\0y\0"s, "c\0-i\0" "3\0z"s};
+    const std::vector<std::pair<int, std::string>> expected{{1, "x"}, {0, "y"}, {3, "z"}};
+    for(size_t i = 0; i < buffers.size(); ++i){
+        EXPECT_NO_THROW(parser.parseCmdline(std::string(buffers[i]), false));
+        EXPECT_EQ(parser.getValue<int>("-i"), expected[i].first);
+        EXPECT_EQ(parser.getValue<std::string>("pos"), expected[i].second);
+        parser.resetParse();
+    }
+    EXPECT_THROW(parser.parseCmdline(""s, false), argParser::parse_error) << "positional missing in empty command line";
+}
+
+MYTEST(ParseProcCmdline){
+    parser.addArgument<bool>("--agent-never-set").finalize();
+    EXPECT_NO_THROW(parser.parseProcCmdline());
+    EXPECT_FALSE(parser["--agent-never-set"].isSet());
+    EXPECT_FALSE(parser.getSelfName().empty());
+    EXPECT_THROW(argParser("", "").parseProcCmdline("/no/such/file"), std::runtime_error);
+}
+
+/// Namespaces
+MYTEST(NamespaceKeys){
+    EXPECT_NO_THROW(parser.addArgument<int>("--db.primary.port").finalize());
+    EXPECT_NO_THROW(parser.addArgument<int>("-d.p", "--db.replica.port").finalize());
+    EXPECT_THROW(parser.addArgument<int>("--db..port"), std::invalid_argument);
+    EXPECT_THROW(parser.addArgument<int>("--.db"), std::invalid_argument);
+    EXPECT_THROW(parser.addArgument<int>("--db."), std::invalid_argument);
+    EXPECT_THROW_WITH_MESSAGE(parser.addArgument<int>("-db.primary.port"), std::invalid_argument,
+                              "addArgument: -db.primary.port namespace path already defined by --db.primary.port");
+    EXPECT_NO_THROW(parser.addArgument<int>("--db.primary").finalize()) << "path of inner node is free";
+    EXPECT_THROW_WITH_MESSAGE(parser.addArgument<int>("--d.p"), std::invalid_argument,
+                              "addArgument: --d.p namespace path already defined by --db.replica.port");
+    EXPECT_THROW_WITH_MESSAGE(parser.addArgument<int>("--port", "-db.primary.port"), std::invalid_argument,
+                              "addArgument: -db.primary.port namespace path already defined by --db.primary.port");
+    EXPECT_THROW_WITH_MESSAGE(parser.addArgument<int>("-x.y", "--x.y"), std::invalid_argument,
+                              "addArgument: -x.y namespace path already defined by --x.y");
+    EXPECT_THROW_WITH_MESSAGE(parser.addPositional<int>("pos.x"), std::invalid_argument,
+                              "addPositional: pos.x cannot contain .");
+    EXPECT_THROW_WITH_MESSAGE(parser.addCommand("cmd.x", ""), std::invalid_argument,
+                              "addCommand: cmd.x cannot contain .");
+}
+
+MYTEST(GetNamespace){
+    parser.addArgument<std::string>("--db.primary.host").parameters("host").defaultValue(std::string("localhost")).finalize();
+    parser.addArgument<int>("--db.primary.port").parameters("port").finalize();
+    parser.addArgument<int>("--db.primary.pool.size").parameters("n").finalize();
+    parser.addArgument<int>("--db.replica.port").parameters("port").finalize();
+    parser.addArgument<int>("--cache.l2.size_mb").parameters("mb").finalize();
+    CallParser({"--db.primary.port=5432", "--db.primary.pool.size", "8", "--db.replica.port", "5433"});
+    auto primary = parser.getNamespace("db.primary");
+    EXPECT_EQ(primary.getValue<std::string>("host"), "localhost");
+    EXPECT_FALSE(primary.isSet("host"));
+    EXPECT_EQ(primary.getValue<int>("port"), 5432);
+    EXPECT_EQ(primary.getValue<int>("pool.size"), 8);
+    EXPECT_THROW(primary.getValue<int>("replica.port"), std::invalid_argument);
+    auto db = parser.getNamespace("--db");
+    EXPECT_EQ(db.getValue<int>("replica.port"), 5433);
+    EXPECT_EQ(db.getValue<int>("primary.pool.size"), 8);
+    EXPECT_EQ(parser.getNamespace("").getValue<int>("cache.l2.size_mb"), 0);
+    EXPECT_THROW(parser.getNamespace("").getValue<bool>("help"), std::invalid_argument) << "only dotted options are indexed";
+    EXPECT_THROW(parser.getNamespace("db.prim"), std::invalid_argument) << "prefix should match whole segments";
+    EXPECT_THROW_WITH_MESSAGE((void)parser.getNamespace("db.primary.port"), std::invalid_argument,
+                              "getNamespace: db.primary.port is not a namespace");
+}
+
+MYTEST(GetNamespaceAlias){
+    parser.addArgument<int>("-c.s", "--cache.size").parameters("n").finalize();
+    CallParser({"-c.s", "5"});
+    EXPECT_EQ(parser.getNamespace("cache").getValue<int>("size"), 5);
+    EXPECT_THROW(parser.getNamespace("cache").getValue<int>("s"), std::invalid_argument) << "aliases aren't listed";
+    EXPECT_THROW_WITH_MESSAGE((void)parser.getNamespace("c"), std::invalid_argument, "getNamespace: c is not a namespace");
+}
+
+/// Abbreviations
+MYTEST(AbbrevUnique){
+    parser.addArgument<bool>("-v", "--verbose").finalize();
+    parser.addArgument<int>("--jobs", "--parallel-jobs").parameters("n").finalize();
+    parser.addArgument<int>("--job-timeout").parameters("s").finalize();
+    parser.allowAbbrev();
+    EXPECT_NO_THROW(CallParser({"--verb", "--jobs", "4", "--job-t=30"}));
+    EXPECT_TRUE(parser.getValue<bool>("--verbose"));
+    EXPECT_EQ(parser.getValue<int>("--jobs"), 4) << "exact key should win over longer keys";
+    EXPECT_EQ(parser.getValue<int>("--job-timeout"), 30);
+}
+
+MYTEST(AbbrevAlias){
+    parser.addArgument<int>("--jobs", "--parallel-jobs").parameters("n").finalize();
+    parser.allowAbbrev();
+    EXPECT_NO_THROW(CallParser({"--par", "2"}));
+    EXPECT_EQ(parser.getValue<int>("--jobs"), 2);
+}
+
+MYTEST(AbbrevAmbiguous){
+    parser.addArgument<bool>("--verbose").finalize();
+    parser.addArgument<bool>("--version").finalize();
+    parser.allowAbbrev();
+    EXPECT_THROW_WITH_MESSAGE(CallParser({"--ver"}), argParser::parse_error, "Ambiguous argument: --ver could match --verbose, --version");
+}
+
+MYTEST(AbbrevCommand){
+    auto &child = parser.addCommand("child", "");
+    child.addArgument<int>("--child-int").parameters("int").finalize();
+    parser.addCommand("config", "");
+    parser.allowAbbrev();
+    EXPECT_NO_THROW(CallParser({"ch", "--child", "5"})) << "commands should inherit abbreviations";
+    EXPECT_EQ(child.getValue<int>("--child-int"), 5);
+}
+
+MYTEST(AbbrevCommandAmbiguous){
+    parser.addCommand("child", "");
+    parser.addCommand("config", "");
+    parser.allowAbbrev();
+    EXPECT_THROW_WITH_MESSAGE(CallParser({"c"}), argParser::parse_error, "Ambiguous command: c could match child, config");
+}
+
+MYTEST(AbbrevCommandOnlyWhereDispatched){
+    parser.addArgument<std::string>("--files").nargs<1, -1>().finalize();
+    parser.addArgument<bool>("--verbose").finalize();
+    parser.addPositional<std::string>("target").finalize();
+    auto &build = parser.addCommand("build", "");
+    build.addArgument<bool>("--release").finalize();
+    parser.allowAbbrev();
+    EXPECT_NO_THROW(CallParser({"--files", "a.txt", "b", "--verb", "b", "bui", "--rel"}));
+    EXPECT_EQ(parser.getValue<std::vector<std::string>>("--files"), std::vector<std::string>({"a.txt", "b"}))
+                        << "values shouldn't be taken for commands";
+    EXPECT_EQ(parser.getValue<std::string>("target"), "b") << "mandatory positional shouldn't be taken for command";
+    EXPECT_TRUE(build.getValue<bool>("--release"));
+}
+
+MYTEST(AbbrevDisabledByDefault){
+    parser.addArgument<bool>("--verbose").finalize();
+    EXPECT_THROW(CallParser({"--verb"}), argParser::parse_error);
+}
+
+MYTEST(AbbrevShortKeys){
+    parser.addArgument<int>("-n").parameters("n").finalize();
+    parser.addArgument<bool>("-nx").finalize();
+    parser.allowAbbrev();
+    EXPECT_NO_THROW(CallParser({"-n5"})) << "short keys shouldn't be abbreviated";
+    EXPECT_EQ(parser.getValue<int>("-n"), 5);
+}
+
+/// Async parse
+MYTEST(ParseAsync){
+    auto main_id = std::this_thread::get_id();
+    std::thread::id callback_id;
+    parser.addArgument<int>("-i").parameters("int").finalize();
+    parser.setCallback([&]{ callback_id = std::this_thread::get_id(); });
+    std::vector<std::string> tokens = {"binary_name", "-i", "5"};
+    std::vector<char*> args;
+    for(auto &t : tokens){
+        args.push_back(&t[0]);
+    }
+    auto result = parser.parseArgsAsync(int(args.size()), args.data());
+    tokens.clear(); // argv is copied
+    EXPECT_EQ(result.get(), 2);
+    EXPECT_TRUE(parser.parsed());
+    EXPECT_EQ(parser.getValue<int>("-i"), 5);
+    EXPECT_NE(callback_id, main_id) << "Callback should run on background thread";
+    EXPECT_NE(callback_id, std::thread::id());
+}
+
+MYTEST(ParseAsyncError){
+    parser.addArgument<int>("-i").parameters("int").finalize();
+    std::vector<const char*> args = {"binary_name", "-j"};
+    auto result = parser.parseArgsAsync(int(args.size()), const_cast<char **>(&args[0]));
+    EXPECT_THROW(result.get(), argParser::parse_error);
+    EXPECT_FALSE(parser.parsed());
+}
+
+/// Limits
+MYTEST(LimitTokens){
+    parser.setLimits({/*max_tokens=*/3});
+    parser.addArgument<int>("-v").repeatable().finalize();
+    EXPECT_NO_THROW(CallParser({"-v", "-v", "-v"}));
+    ASSERT_EQ(parser.getValue<int>("-v"), 3);
+}
+
+MYTEST(LimitTokensExceeded){
+    parser.setLimits({/*max_tokens=*/3});
+    parser.addArgument<int>("-v").repeatable().finalize();
+    try{
+        CallParser({"-v", "-v", "-v", "-v"});
+        FAIL() << "Expected limit_error";
+    }catch(const argParser::limit_error &e){
+        EXPECT_EQ(e.which(), argParser::limit_error::limit::TOKENS);
+        EXPECT_EQ(e.maximum(), 3);
+    }
+}
+
+MYTEST(LimitTokensCombinedArgs){
+    parser.setLimits({/*max_tokens=*/3});
+    parser.addArgument<int>("-v").repeatable().finalize();
+    EXPECT_THROW(CallParser({"-vvvv"}), argParser::limit_error) << "Combined args are counted after splitting";
+}
+
+MYTEST(LimitBytes){
+    argParser::Limits limits;
+    limits.max_bytes = 8;
+    parser.setLimits(limits);
+    parser.addArgument<std::string>("-s").parameters("str").finalize();
+    EXPECT_THROW_WITH_MESSAGE(CallParser({"-s", "1234567"}), argParser::limit_error,
+                              "binary_name: size of arguments exceeds limit of 8 bytes");
+}
+
+MYTEST(LimitBytesBeforeSplitting){
+    argParser::Limits limits;
+    limits.max_bytes = 8;
+    parser.setLimits(limits);
+    parser.addArgument<std::string>("-s").parameters("str").finalize();
+    EXPECT_THROW(parser.parseCommandLine("-s '1234567"), argParser::limit_error) << "Line should be rejected before it's split";
+}
+
+MYTEST(LimitBytesResponseFile){
+    argParser::Limits limits;
+    limits.max_bytes = 32;
+    parser.setLimits(limits);
+    parser.responseFiles();
+    parser.addArgument<std::string>("-s").parameters("str").finalize();
+    auto file = WriteResponseFile("argparser_rsp_limit", "-s '" + std::string(64, 'a'));
+    try{
+        CallParser({file.c_str()});
+        FAIL() << "Expected limit_error";
+    }catch(const argParser::limit_error &e){
+        EXPECT_EQ(e.which(), argParser::limit_error::limit::BYTES) << "File should be rejected before it's split";
+    }
+}
+
+MYTEST(LimitValues){
+    argParser::Limits limits;
+    limits.max_values = 3;
+    parser.setLimits(limits);
+    parser.addArgument<int>("-l").nargs<0,-1>().finalize();
+    parser.addPositional<int>("pos").nargs<1,-1>().finalize();
+    EXPECT_THROW_WITH_MESSAGE(CallParser({"1", "2", "-l", "1", "2", "3", "4"}), argParser::limit_error,
+                              "-l: 4 values exceed limit of 3");
+}
+
+MYTEST(LimitValuesPositional){
+    argParser::Limits limits;
+    limits.max_values = 3;
+    parser.setLimits(limits);
+    parser.addPositional<int>("pos").nargs<1,-1>().finalize();
+    EXPECT_THROW(CallParser({"1", "2", "3", "4"}), argParser::limit_error);
+}
+
+MYTEST(LimitCommandDepth){
+    argParser::Limits limits;
+    limits.max_command_depth = 1;
+    parser.setLimits(limits);
+    auto &cmd = parser.addCommand("cmd", "command");
+    cmd.addCommand("sub", "subcommand");
+    try{
+        CallParser({"cmd", "sub"});
+        FAIL() << "Expected limit_error";
+    }catch(const argParser::limit_error &e){
+        EXPECT_EQ(e.which(), argParser::limit_error::limit::COMMAND_DEPTH);
+    }
+}
+
+MYTEST(LimitTypoWork){
+    argParser::Limits limits;
+    limits.max_typo_work = 100;
+    parser.setLimits(limits);
+    for(int i = 0; i < 20; ++i){
+        auto key = "--option" + std::to_string(i);
+        parser.addArgument<int>(key.c_str()).parameters("int").finalize();
+    }
+    parser.addPositional<std::string>("pos").finalize();
+    EXPECT_THROW(CallParser({"--optiom"}), argParser::limit_error);
+}
+
+/// Live reload
+MYTEST(LiveReloadNotEnabled){
+    parser.addArgument<int>("-i").parameters("int").finalize();
+    CallParser({"-i", "1"});
+    EXPECT_THROW(CallReload({"-i", "2"}), std::logic_error);
+    EXPECT_THROW((void)parser.values(), std::runtime_error);
+}
+
+MYTEST(LiveReloadPublishesValues){
+    std::atomic<int> i{0};
+    parser.liveReload();
+    parser.addArgument<int>("-i", "--int").parameters("int").globalPtr(&i).finalize();
+    parser.addArgument<std::string>("-s").parameters("str").defaultValue(std::string("def")).finalize();
+    CallParser({"-i", "1", "-s", "first"});
+    const auto &first = parser.values();
+    EXPECT_EQ(first.getValue<int>("--int"), 1);
+    EXPECT_EQ(first.getValue<int>("-i"), 1);
+    EXPECT_TRUE(first.isSet("-s"));
+    CallReload({"-i", "2"});
+    const auto &second = parser.values();
+    EXPECT_EQ(second.version(), first.version() + 1);
+    EXPECT_EQ(second.getValue<int>("--int"), 2);
+    EXPECT_EQ(second.getValue<std::string>("-s"), "def") << "Options not specified on reload should return to their defaults";
+    EXPECT_FALSE(second.isSet("-s"));
+    EXPECT_EQ(first.getValue<std::string>("-s"), "first") << "Previously published values should stay intact";
+    EXPECT_EQ(parser.getValue<int>("--int"), 2);
+    EXPECT_EQ(i, 2);
+}
+
+MYTEST(LiveReloadRollbackOnError){
+    std::atomic<int> i{0};
+    parser.liveReload();
+    parser.addArgument<int>("-i").parameters("int").globalPtr(&i).finalize();
+    parser.addArgument<int>("-j").parameters("int").finalize();
+    CallParser({"-i", "1", "-j", "1"});
+    EXPECT_THROW(CallReload({"-i", "2", "-j", "abc"}), argParser::unparsed_param);
+    EXPECT_EQ(i, 1) << "Global should not be updated with half-applied values";
+    EXPECT_EQ(parser.values().getValue<int>("-i"), 1);
+    EXPECT_EQ(parser.values().version(), 1);
+    EXPECT_EQ(parser.getValue<int>("-i"), 1);
+    EXPECT_TRUE(parser["-j"].isSet());
+}
+
+MYTEST(LiveReloadPlainGlobalPtr){
+    int i = 0;
+    parser.addArgument<int>("-i").parameters("int").globalPtr(&i).finalize();
+    EXPECT_THROW(parser.liveReload(), std::logic_error) << "Plain global cannot be updated atomically";
+    int j = 0;
+    argParser live;
+    live.liveReload();
+    EXPECT_THROW(live.addArgument<int>("-j", "--jj").parameters("int").globalPtr(&j).finalize(), std::logic_error);
+    EXPECT_THROW((void)live["--jj"], std::invalid_argument) << "Rejected argument should not be registered";
+    EXPECT_THROW((void)live["-j"], std::invalid_argument);
+}
+
+MYTEST(LiveReloadDeferredValues){
+    int calls = 0;
+    parser.addArgument<int>("-l")
+            .parameters("int")
+            .callable([&calls](const char *arg){ ++calls; return std::stoi(arg); })
+            .lazy()
+            .finalize();
+    EXPECT_THROW(parser.liveReload(), std::logic_error) << "publishing would run lazy callable";
+    argParser live;
+    live.liveReload();
+    EXPECT_THROW(live.addArgument<int>("-k").parameters("int").callable([](const char *){ return 1; }).lazy().finalize(),
+                 std::logic_error);
+    EXPECT_THROW((void)live["-k"], std::invalid_argument);
+}
+
+MYTEST(LiveReloadDefaultProviderOnRead){
+    std::atomic<int> calls = 0;
+    parser.addArgument<int>("-j").parameters("n").defaultProvider([&calls]{ ++calls; return 8; }).finalize();
+    parser.liveReload();
+    CallParser({});
+    EXPECT_EQ(calls, 0) << "publishing shouldn't run default provider";
+    EXPECT_FALSE(parser.values().isSet("-j"));
+    EXPECT_EQ(calls, 0);
+    EXPECT_EQ(parser.values().getValue<int>("-j"), 8);
+    EXPECT_EQ(calls, 1);
+    CallReload({});
+    EXPECT_EQ(parser.values().getValue<int>("-j"), 8);
+    EXPECT_EQ(parser.getValue<int>("-j"), 8);
+    EXPECT_EQ(calls, 1) << "provider value is memoized";
+}
+
+MYTEST(LiveReloadSnapshotOutlivesReloads){
+    parser.liveReload();
+    parser.addArgument<const char*>("-s").parameters("str").finalize();
+    CallParser({"-s", "first"});
+    {
+        const auto &first = parser.values();
+        for(int n = 0; n < 10; ++n){
+            CallReload({"-s", std::to_string(n).c_str()});
+        }
+        EXPECT_STREQ(first.getValue<const char*>("-s"), "first") << "Snapshot should keep values and their tokens alive";
+        EXPECT_EQ(first.version(), 1);
+    }
+    CallReload({"-s", "last"});
+    EXPECT_STREQ(parser.values().getValue<const char*>("-s"), "last");
+    EXPECT_EQ(parser.values()->version(), 12);
+}
+
+MYTEST(LiveReloadImmutable){
+    parser.liveReload();
+    parser.addArgument<const char*>("-s").parameters("str").immutable().finalize();
+    parser.addArgument<int>("-i").parameters("int").finalize();
+    CallParser({"-s", "abc", "-i", "1"});
+    EXPECT_NO_THROW(CallReload({"-s", "abc", "-i", "2"})) << "Same value for immutable argument is allowed";
+    EXPECT_THROW_WITH_MESSAGE(CallReload({"-s", "abd", "-i", "3"}), argParser::parse_error, "-s: cannot be changed at runtime");
+    EXPECT_THROW(CallReload({"-i", "3"}), argParser::parse_error);
+    EXPECT_EQ(parser.values().getValue<int>("-i"), 2);
+    EXPECT_STREQ(parser.values().getValue<const char*>("-s"), "abc");
+}
+
+MYTEST(LiveReloadConcurrentReaders){
+    parser.liveReload();
+    parser.addArgument<int>("-a").parameters("int").finalize();
+    parser.addArgument<int>("-b").parameters("int").finalize();
+    CallParser({"-a", "0", "-b", "0"});
+    std::atomic<bool> done{false};
+    std::atomic<int> mismatches{0};
+    std::thread reader([&]{
+        while(!done){
+            const auto &v = parser.values();
+            if(v.getValue<int>("-a") != v.getValue<int>("-b")){
+                ++mismatches;
+            }
+        }
+    });
+    for(int n = 1; n < 200; ++n){
+        auto s = std::to_string(n);
+        CallReload({"-a", s.c_str(), "-b", s.c_str()});
+    }
+    done = true;
+    reader.join();
+    EXPECT_EQ(mismatches, 0);
+    EXPECT_EQ(parser.values().getValue<int>("-b"), 199);
+}
@@ -0,0 +1,190 @@
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <new>
+#define ARGPARSER_INSTRUMENTATION
+#include "argparser.hpp"
+
+#define FIXTURE UtestAlloc
+#define MYTEST(NAME) TEST_F(FIXTURE, NAME)
+
+/// Counting allocator. Counts only allocations of the current thread made while counting is enabled
+namespace {
+    thread_local bool counting = false;
+    thread_local size_t allocations = 0;
+    thread_local size_t allocated_bytes = 0;
+}
+
+void *operator new(std::size_t size){
+    if(counting){
+        ++allocations;
+        allocated_bytes += size;
+    }
+    if(void *p = std::malloc(size ? size : 1)){
+        return p;
+    }
+    throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept{
+    std::free(p);
+}
+void operator delete(void *p, std::size_t) noexcept{
+    std::free(p);
+}
+
+// enables counting in scope
+struct allocationScope{
+    size_t start_allocations = allocations;
+    size_t start_bytes = allocated_bytes;
+    allocationScope() {counting = true;}
+    ~allocationScope() {counting = false;}
+    [[nodiscard]] size_t count() const {return allocations - start_allocations;}
+    [[nodiscard]] size_t bytes() const {return allocated_bytes - start_bytes;}
+};
+
+bool starts_with(const std::string &s, const std::string &prefix){
+    return s.compare(0, prefix.size(), prefix) == 0;
+}
+
+// reports allocations per phase
+class allocationObserver : public parseObserver {
+public:
+    std::map<std::string, counters> phases;
+    void onPhase(phase p, const std::string &key, std::chrono::nanoseconds elapsed, const counters &delta) override {
+        // don't count own bookkeeping
+        counting = false;
+        auto &c = phases[name(p) + (p == phase::ARGUMENT ? " " + key : "")];
+        c.allocations += delta.allocations;
+        c.allocated_bytes += delta.allocated_bytes;
+        counting = true;
+    }
+    [[nodiscard]] size_t allocationCount() const override {return allocations;}
+    [[nodiscard]] size_t allocatedBytes() const override {return allocated_bytes;}
+    void print() const {
+        for(const auto &x : phases){
+            std::cout << "[ alloc    ] " << x.first << ": " << x.second.allocations
+                      << " allocations, " << x.second.allocated_bytes << " bytes" << std::endl;
+        }
+    }
+private:
+    static std::string name(phase p) {
+        switch(p){
+            case phase::PREPROCESS: return "preprocess";
+            case phase::ARGUMENT: return "argument";
+            case phase::TYPOS: return "typos";
+            case phase::CALLBACK: return "callback";
+            case phase::PARSE: return "parse";
+        }
+        return "";
+    }
+};
+
+class FIXTURE : public testing::Test {
+protected:
+    argParser parser;
+    allocationObserver observer;
+    explicit FIXTURE()
+            : parser("binary_name", ""){
+        parser.setObserver(&observer);
+    }
+
+    // typical spec: flags, options with aliases, '=' and adjacent forms, positional
+    void AddTypicalSpec(){
+        parser.addArgument<bool>("-v", "--verbose").finalize();
+        parser.addArgument<int>("-j", "--jobs").parameters("n").defaultValue(1).finalize();
+        parser.addArgument<double>("--ratio").parameters("r").finalize();
+        parser.addArgument<int>("-n").parameters("num").finalize();
+        parser.addArgument<std::string>("--name").parameters("name").finalize();
+        parser.addArgument<int>("-x").repeatable().finalize();
+        parser.addPositional<int>("pos").finalize();
+    }
+
+    // returns allocations made by parse
+    size_t CallParser(std::vector<const char*> args){
+        args.insert(args.begin(), "binary_name");
+        allocationScope scope;
+        parser.parseArgs(int(args.size()), const_cast<char **>(&args[0]));
+        auto res = scope.count();
+        counting = false;
+        observer.print();
+        std::cout << "[ alloc    ] total: " << res << " allocations, " << scope.bytes() << " bytes" << std::endl;
+        return res;
+    }
+};
+
+// parse allocates copy of argv, preprocessed tokens and typo check buffers for the positional token,
+// conversions, actions, callback and reads don't allocate. Counts are exact, so any change shows up
+MYTEST(TypicalParse){
+    AddTypicalSpec();
+    auto count = CallParser({"-v", "--jobs", "8", "--ratio=0.5", "-n3", "--name", "short", "-xx", "42"});
+    EXPECT_EQ(count, 4);
+    for(const auto &x : observer.phases){
+        if(starts_with(x.first, "argument")){
+            EXPECT_EQ(x.second.allocations, 0) << x.first;
+        }
+    }
+    EXPECT_EQ(observer.phases["callback"].allocations, 0);
+    EXPECT_EQ(observer.phases["preprocess"].allocations, 1);
+    EXPECT_EQ(observer.phases["typos"].allocations, 2);
+}
+
+MYTEST(TypoDetectionDoesNotDependOnSpecSize){
+    for(int i = 0; i < 100; ++i){
+        auto key = "--option-" + std::to_string(i);
+        parser.addArgument<int>(key.c_str()).parameters("int").finalize();
+    }
+    parser.addPositional<int>("pos").finalize();
+    CallParser({"--option-1", "1", "42"});
+    EXPECT_EQ(observer.phases["typos"].allocations, 2) << "distance buffer should be reused for all keys";
+}
+
+MYTEST(ConversionsDoNotAllocate){
+    allocationScope scope;
+    auto i = argParser::scanValue<int>("-1234567");
+    auto h = argParser::scanValue<unsigned>("0xFF");
+    auto c = argParser::scanValue<char>("65");
+    auto d = argParser::scanValue<double>("1.5e-3");
+    auto f = argParser::scanValue<float>("0.25");
+    auto b = argParser::scanValue<bool>("Yes");
+    auto count = scope.count();
+    EXPECT_EQ(count, 0);
+    EXPECT_TRUE(i == -1234567 && h == 255 && c == 'A' && d == 1.5e-3 && f == 0.25f && b);
+}
+
+MYTEST(ReadValuesDoesNotAllocate){
+    AddTypicalSpec();
+    CallParser({"-v", "-j", "8", "--ratio=0.5", "--name", "short", "42"});
+    allocationScope scope;
+    auto v = parser.getValue<bool>("--verbose");
+    auto j = parser.getValue<int>("-j");
+    auto r = parser.getValue<double>("--ratio");
+    int pos = parser["pos"];
+    bool set = parser["-n"].isSet();
+    auto count = scope.count();
+    EXPECT_EQ(count, 0);
+    EXPECT_TRUE(v && j == 8 && r == 0.5 && pos == 42 && !set);
+}
+
+MYTEST(AppendToSingleAllocation){
+    std::vector<int> values;
+    parser.addArgument<int>("-l").nargs<1,-1>().appendTo(&values).finalize();
+    std::vector<std::string> tokens(100, "7");
+    std::vector<const char*> args{"-l"};
+    for(const auto &t : tokens){
+        args.push_back(t.c_str());
+    }
+    CallParser(args);
+    EXPECT_EQ(observer.phases["argument -l"].allocations, 1) << "container should be reserved once";
+    EXPECT_EQ(values.size(), 100);
+}
+
+MYTEST(AppendToRepeatedGrowsGeometrically){
+    std::vector<int> values;
+    parser.addArgument<int>("-p").nargs<2>().repeatable().appendTo(&values).finalize();
+    std::vector<const char*> args;
+    for(int i = 0; i < 500; ++i){
+        args.insert(args.end(), {"-p", "1", "2"});
+    }
+    CallParser(args);
+    EXPECT_EQ(values.size(), 1000);
+    EXPECT_EQ(observer.phases["argument -p"].allocations, 10) << "container should not be reallocated for every occurrence";
+}
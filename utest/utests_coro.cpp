@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+#include <future>
+#include <thread>
+#include "argparser.hpp"
+
+#define FIXTURE UtestCoro
+#define MYTEST(NAME) TEST_F(FIXTURE, NAME)
+
+// minimal eager coroutine, reports result through a promise
+struct task{
+    struct promise_type{
+        task get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+class FIXTURE : public testing::Test {
+protected:
+    argParser parser;
+    std::vector<const char*> args;
+    explicit FIXTURE()
+            : parser("", ""){}
+
+    task Parse(argParser &p, std::promise<int> &result, std::vector<const char*> cli){
+        args = std::move(cli);
+        args.insert(args.begin(), "binary_name");
+        try{
+            result.set_value(co_await p.parseArgsAwaitable(int(args.size()), const_cast<char **>(&args[0])));
+        }catch(...){
+            result.set_exception(std::current_exception());
+        }
+    }
+};
+
+MYTEST(AwaitParse){
+    parser.addArgument<int>("-i").parameters("int").finalize();
+    std::promise<int> result;
+    Parse(parser, result, {"-i", "5"});
+    EXPECT_EQ(result.get_future().get(), 2);
+    EXPECT_EQ(parser.getValue<int>("-i"), 5);
+}
+
+MYTEST(AwaitParseError){
+    parser.addArgument<int>("-i").parameters("int").finalize();
+    std::promise<int> result;
+    Parse(parser, result, {"-i", "abc"});
+    EXPECT_THROW(result.get_future().get(), argParser::unparsed_param);
+}
+
+MYTEST(ParserJoinsAwaitThread){
+    std::atomic<bool> done = false;
+    auto local = std::make_unique<argParser>("", "");
+    local->setCallback([&done]{
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        done = true;
+    });
+    std::promise<int> result;
+    auto future = result.get_future();
+    Parse(*local, result, {});
+    local.reset();
+    EXPECT_TRUE(done) << "parser should wait for background parse";
+    EXPECT_EQ(future.get(), 0);
+}
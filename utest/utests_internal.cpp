@@ -16,6 +16,9 @@ public:
     void printHelpForParamTest(const std::string &param) {
         argParser::printHelpForParameter(param);
     }
+    size_t retiredValuesTest() const {
+        return m_retired[0].size() + m_retired[1].size();
+    }
 };
 
 // Create a test fixture
@@ -382,6 +385,19 @@ MYTEST(helpCommonVariadicWithChoices) {
     EXPECT_EQ(lines[5], "\t--choices4 <0|1|2|3> [0|1|2|3]... : ");
 }
 
+MYTEST(helpWideNargs) {
+    parser.addArgument<int>("-a").nargs<1, 100000>().finalize();
+    parser.addArgument<int>("-b").nargs<6>().finalize();
+    parser.addArgument<int>("-c").nargs<5, -1>().finalize();
+    parser.addPositional<int>("pos").nargs<0, 10>().finalize();
+    parser.printHelpCommonTest(false);
+    auto lines = GetOutLines();
+    EXPECT_EQ(lines[0], "Usage:  [flags]... [pos]...{0..10}");
+    EXPECT_EQ(lines[5], "\t-a <A> [A]...{1..100000} : ");
+    EXPECT_EQ(lines[6], "\t-b <B>...{6} : ");
+    EXPECT_EQ(lines[7], "\t-c <C> [C]...{5..} : ");
+}
+
 MYTEST(helpRepeatable) {
     parser.addArgument<int>("-i")
             .repeatable()
@@ -402,6 +418,19 @@ MYTEST(helpDefault) {
     EXPECT_EQ(lines[3], "\t-i :  (default 5)");
 }
 
+MYTEST(helpDefaultProvider) {
+    int calls = 0;
+    parser.addArgument<int>("-j")
+            .parameters("n")
+            .defaultProvider([&calls]{ ++calls; return 8; }, "number of cores")
+            .finalize();
+    parser.printHelpCommonTest(false);
+    auto lines = GetOutLines();
+    ASSERT_EQ(lines.size(), 4);
+    EXPECT_EQ(lines[3], "\t-j <n> :  (default number of cores)");
+    EXPECT_EQ(calls, 0);
+}
+
 MYTEST(helpForParam) {
     parser.addArgument<int>("-i")
             .help("help message")
@@ -414,3 +443,102 @@ MYTEST(helpForParam) {
     EXPECT_EQ(lines[1], "advanced help message");
 }
 
+class observerFake : public parseObserver {
+public:
+    struct event{
+        phase p;
+        std::string key;
+        counters delta;
+    };
+    std::vector<event> events;
+    size_t allocations = 0;
+    void onPhase(phase p, const std::string &key, std::chrono::nanoseconds elapsed, const counters &delta) override {
+        events.push_back({p, key, delta});
+    }
+    [[nodiscard]] size_t allocationCount() const override {
+        return allocations;
+    }
+    [[nodiscard]] std::vector<event> find(phase p) const {
+        std::vector<event> res;
+        std::copy_if(events.begin(), events.end(), std::back_inserter(res), [p](const auto &e){return e.p == p;});
+        return res;
+    }
+};
+
+MYTEST(observerPhases) {
+    observerFake observer;
+    parser.setObserver(&observer);
+    parser.addArgument<int>("-i").parameters("int").finalize();
+    parser.addArgument<int>("-j")
+            .nargs<2>()
+            .callable([&observer](const char *s){
+                observer.allocations += 3;
+                return argParser::scanValue<int>(s);
+            })
+            .finalize();
+    std::vector<const char*> args = {"app", "-i=1", "-j", "2", "3"};
+    parser.parseArgs(int(args.size()), const_cast<char **>(&args[0]));
+
+    using phase = parseObserver::phase;
+    ASSERT_EQ(observer.find(phase::PREPROCESS).size(), 1);
+    EXPECT_EQ(observer.find(phase::PREPROCESS)[0].delta.tokens, 5);
+    auto arguments = observer.find(phase::ARGUMENT);
+    ASSERT_EQ(arguments.size(), 2);
+    EXPECT_EQ(arguments[0].key, "-i");
+    EXPECT_EQ(arguments[0].delta.tokens, 1);
+    EXPECT_EQ(arguments[1].key, "-j");
+    EXPECT_EQ(arguments[1].delta.tokens, 2);
+    EXPECT_EQ(arguments[1].delta.allocations, 6);
+    EXPECT_EQ(observer.find(phase::CALLBACK).size(), 1);
+    EXPECT_TRUE(observer.find(phase::TYPOS).empty());
+    ASSERT_EQ(observer.find(phase::PARSE).size(), 1);
+    EXPECT_EQ(observer.events.back().p, phase::PARSE);
+    EXPECT_EQ(observer.events.back().delta.conversions, 2);
+    EXPECT_EQ(observer.events.back().delta.allocations, 6);
+}
+
+MYTEST(observerTyposAndCommands) {
+    observerFake observer;
+    parser.setObserver(&observer);
+    auto &child = parser.addCommand("child", "child command");
+    child.addArgument<int>("--int").parameters("int").finalize();
+    std::vector<const char*> args = {"app", "child", "--int", "5"};
+    parser.parseArgs(int(args.size()), const_cast<char **>(&args[0]));
+
+    using phase = parseObserver::phase;
+    ASSERT_EQ(observer.find(phase::TYPOS).size(), 1);
+    EXPECT_EQ(observer.find(phase::TYPOS)[0].key, "child");
+    auto arguments = observer.find(phase::ARGUMENT);
+    ASSERT_EQ(arguments.size(), 1) << "Command should report to parent's observer";
+    EXPECT_EQ(arguments[0].key, "--int");
+    EXPECT_EQ(observer.find(phase::PARSE).size(), 2);
+}
+
+MYTEST(liveReloadReclaimsValues) {
+    parser.liveReload();
+    parser.addArgument<int>("-i").parameters("int").finalize();
+    auto call = [this](const char *value, bool reload) {
+        std::vector<const char*> args = {"app", "-i", value};
+        if(reload){
+            parser.reload(int(args.size()), const_cast<char **>(&args[0]));
+        }else{
+            parser.parseArgs(int(args.size()), const_cast<char **>(&args[0]));
+        }
+    };
+    call("0", false);
+    for(int n = 0; n < 100; ++n){
+        call("1", true);
+    }
+    EXPECT_LE(parser.retiredValuesTest(), 1) << "Values without readers should be freed";
+    {
+        auto snapshot = parser.values();
+        for(int n = 0; n < 10; ++n){
+            call("2", true);
+        }
+        EXPECT_GE(parser.retiredValuesTest(), 10) << "Values cannot be freed while snapshot exists";
+        EXPECT_EQ(snapshot.getValue<int>("-i"), 1);
+    }
+    call("3", true);
+    call("3", true);
+    EXPECT_LE(parser.retiredValuesTest(), 1) << "Values should be freed once snapshot is released";
+}